@@ -1,11 +1,19 @@
 #include "stb_image.h"
 #include <iostream>
 #include <complex>
+#include <chrono>
 #include <limits>
 #include <math.h>
 #include "fourier.h"
+#include "fft.h"
+#include "fft_kernels.h"
+#include "parallel.h"
+#include "sequences.h"
+#include "sincos.h"
+#include "wavelet_kernels.h"
 #include "imgui.h"
 #include "implot.h"
+#include "implot_internal.h"
 #include "algorithm"
 
 // System includes
@@ -53,6 +61,15 @@ const char* fourier::strategies[] = { "integers",
 										"square", };
 //"inv. custom",}; broken
 
+const char* fourier::sincosTiers[] = { "exact (libm)",
+	"fast (1e-7)",
+	"table (1e-4)" };
+
+const char* fourier::selections[] = { "all (up to max nodes)",
+										"largest (num of nodes)",
+										"energy fraction",
+										"rms error", };
+
 const char* fourier::curves[] = { "sin(x)",
 								"cos(x)",
 								"sin(x)^2 + cos(x)",
@@ -74,6 +91,8 @@ ExampleAppConsole fourier::console = {};
 ExampleAppLog fourier::log = {};
 WaveletGenerator fourier::waveletGenerator = { 64 };
 ScrollingBuffer fourier::tracer = { 100000 };
+PolylineSimplifier fourier::traceSimplifier = {};
+PolylineSimplifier fourier::captureSimplifier = {};
 ScrollingBuffer fourier::result = { 1000000 };
 ScrollingBuffer fourier::dataAnalog[3] = { {MAX_PLOT}, {MAX_PLOT}, };
 ScrollingBuffer fourier::dataModulated = { MAX_PLOT };
@@ -86,9 +105,6 @@ ScrollingBuffer fourier::demodulator[NUM_DEMODULATOR_GRAPHS] = { {MAX_PLOT},
 
 std::vector<float> fourier::Xaxis = {};
 std::vector<float> fourier::Yaxis = {};
-std::vector<WaveletStruct> fourier::Xdft = {};
-std::vector<WaveletStruct> fourier::Ydft = {};
-std::vector<WaveletStruct> fourier::Cdft = {};
 ImVector<ImVec2> fourier::points = {};
 
 fourier::fourier()
@@ -99,6 +115,9 @@ fourier::fourier()
 	isConsole = true;
 	isLog = true;
 	isAlternateSeries = false;
+	isRotorMode = false;
+	isSynthesisMode = false;
+	numHarmonics = 100000;
 	time = 0.0f;
 	timePlot = 0.0f;
 	clear_color = ImVec4(0.15f, 0.15f, 0.15f, 1.00f);
@@ -115,15 +134,27 @@ fourier::fourier()
 	numNodes = 8;
 	showCircles = true;
 	showEdges = true;
+	showTracePoints = true;
+	traceBudget = TRACE_VERTEX_BUDGET;
+	simplifyTolerance = 0.5f;
 	strategy_current = 0;
 	curve_current = 0;
 	concept_current = 0;
+	selection_current = 0;
+	sincos_current = SinCos::Fast;
+	energyFraction = 0.999f;
+	rmsError = 1.0f;
+	spectrumGeneration = 0;
+	culledEpicycles = 0;
+	isCurveWorker = false;
 }
 
 void fourier::ShowGUI()
 {
 	DrawAppDockSpace(isDockspace);
 	DrawProperties();
+	if (concept_current != 1)
+		curveWorker.Stop();
 	switch (concept_current)
 	{
 	case 0: // fourier series
@@ -155,11 +186,276 @@ void fourier::ShowGUI()
 
 void fourier::Init()
 {
+	// the scrolling plots may be zoomed out over their whole history
+	dataAnalog[0].EnablePyramid();
+	dataAnalog[1].EnablePyramid();
 	waveletGenerator.Clear();
 	waveletGenerator.SetRadius(radiusCircle);
 	Setup();
 }
 
+// the sequence of the strategies 3 to 9 of the fourier series
+static Sequences::Kind StrategySequence(int strategy)
+{
+	static const Sequences::Kind kinds[] = { Sequences::Fibonacci, Sequences::Primes, Sequences::UnevenPrimes, Sequences::EvenPrimes,
+		Sequences::BalancedPrimes, Sequences::Emirps, Sequences::EulerIrregularPrimes };
+	return kinds[strategy - 3];
+}
+
+// position on a precomputed path at the given time, linear between the samples
+static ImVec2 SamplePath(const std::vector<ImVec2>& path, float time)
+{
+	const size_t n = path.size();
+	const double pos = time / TWO_PI * n;
+	const size_t i = static_cast<size_t>(pos) % n;
+	const size_t j = (i + 1) % n;
+	const float f = static_cast<float>(pos - floor(pos));
+	return ImVec2(path[i].x + (path[j].x - path[i].x) * f, path[i].y + (path[j].y - path[i].y) * f);
+}
+
+// draws the trace from the oldest to the newest sample (skipping the first ones), in canvas coordinates around origin.
+// the ring buffer holds them in two spans, [Offset, size) and then [0, Offset). the samples are strided down so the
+// trace stays within the vertex budget (up to 4 vertices per polyline point, 4 per point quad), the polyline is
+// emitted in batches of TRACE_BATCH points that share their end points, each of them fits into one draw command
+static void DrawTrace(ImDrawList* draw_list, const ScrollingBuffer& trace, int first, ImVec2 origin, bool drawPoints, int budget, ImU32 color)
+{
+	const int size = trace.Data.Size;
+	const int count = size - first;
+	if (count < 2)
+		return;
+
+	const int perPoint = drawPoints ? 8 : 4;
+	const int stride = count * perPoint > budget ? (count * perPoint + budget - 1) / budget : 1;
+
+	static ImVector<ImVec2> batch;
+	batch.resize(0);
+	int quads = 0; // points of the batch that still need their quad, the shared first one has it already
+	auto flush = [&]()
+	{
+		draw_list->AddPolyline(batch.Data, batch.Size, color, ImDrawFlags_None, 2.0f);
+		if (drawPoints)
+		{
+			draw_list->PrimReserve(quads * 6, quads * 4);
+			for (int i = batch.Size - quads; i < batch.Size; i++)
+				draw_list->PrimRect(ImVec2(batch[i].x - 1.0f, batch[i].y - 1.0f), ImVec2(batch[i].x + 1.0f, batch[i].y + 1.0f), color);
+		}
+		const ImVec2 last = batch.back();
+		batch.resize(1);
+		batch[0] = last;
+		quads = 0;
+	};
+
+	const ImVec2* spans[2] = { trace.Data.Data + trace.Offset, trace.Data.Data };
+	const int lengths[2] = { size - trace.Offset, trace.Offset };
+	int j = first;
+	for (int span = 0; span < 2; span++)
+	{
+		for (; j < lengths[span]; j += stride)
+		{
+			batch.push_back(ImVec2(origin.x + spans[span][j].x, origin.y + spans[span][j].y));
+			quads++;
+			if (batch.Size == TRACE_BATCH)
+				flush();
+		}
+		j -= lengths[span];
+	}
+
+	// the newest sample is always part of the trace
+	if (j != stride - 1)
+	{
+		const ImVec2 newest = trace.Newest();
+		batch.push_back(ImVec2(origin.x + newest.x, origin.y + newest.y));
+		quads++;
+	}
+	if (batch.Size > 1)
+		flush();
+}
+
+// the points within the x limits, in ring order from offset, plus the one to either side: the x of the points only
+// ever grows or only ever shrinks, so the first and the last are found by binary search
+static void VisibleSlice(const ImVec2* data, int size, int offset, const ImPlotRect& limits, int& first, int& end)
+{
+	// in keys that grow with the index
+	const float direction = data[(offset + size - 1) % size].x >= data[offset].x ? 1.0f : -1.0f;
+	const double low = direction > 0.0f ? limits.X.Min : -limits.X.Max;
+	const double high = direction > 0.0f ? limits.X.Max : -limits.X.Min;
+	int from = 0, to = size;
+	while (from < to) {
+		const int mid = from + (to - from) / 2;
+		if (direction * data[(offset + mid) % size].x < low)
+			from = mid + 1;
+		else
+			to = mid;
+	}
+	first = from > 0 ? from - 1 : 0;
+	to = size;
+	while (from < to) {
+		const int mid = from + (to - from) / 2;
+		if (direction * data[(offset + mid) % size].x <= high)
+			from = mid + 1;
+		else
+			to = mid;
+	}
+	end = from < size ? from + 1 : size;
+}
+
+// the min/max envelope of every pixel column of the plot of the points, walked in ring order from offset. every run of
+// them within one column is kept as its minimum and maximum (in the order they came), a run outside the x limits only
+// as the point next to the visible ones, so the line still leaves the plot at the right height.
+// only the visible slice is walked
+static void ReduceToEnvelope(ImVector<ImVec2>& envelope, const ImVec2* data, int size, int offset, const ImPlotRect& limits, float width)
+{
+	const double scale = width / limits.X.Size();
+	const int columns = static_cast<int>(width);
+	envelope.resize(0);
+	int column = INT_MIN; // of the current run, -1 left and columns right of the plot
+	ImVec2 low, high, outside;
+	int lowAt = 0, highAt = 0;
+	bool hasOutside = false;
+	int first = 0, end = 0;
+	VisibleSlice(data, size, offset, limits, first, end);
+	for (int i = first, j = (offset + first) % size; i < end; i++, j = j + 1 < size ? j + 1 : 0) {
+		const ImVec2& p = data[j];
+		const double x = (p.x - limits.X.Min) * scale;
+		const int c = x < 0.0 ? -1 : x >= columns ? columns : static_cast<int>(x);
+		if (c != column && column >= 0 && column < columns) {
+			// the run within the plot ends
+			envelope.push_back(lowAt <= highAt ? low : high);
+			if (lowAt != highAt)
+				envelope.push_back(lowAt <= highAt ? high : low);
+		}
+		if (c < 0 || c >= columns) {
+			if (column >= 0 && column < columns)
+				envelope.push_back(p); // leaves the plot
+			else
+				outside = p;
+			hasOutside = !(column >= 0 && column < columns);
+		}
+		else if (c != column) {
+			if (hasOutside)
+				envelope.push_back(outside); // enters the plot
+			hasOutside = false;
+			low = high = p;
+			lowAt = highAt = i;
+		}
+		else {
+			if (p.y < low.y) {
+				low = p;
+				lowAt = i;
+			}
+			if (p.y > high.y) {
+				high = p;
+				highAt = i;
+			}
+		}
+		column = c;
+	}
+	if (column >= 0 && column < columns) {
+		envelope.push_back(lowAt <= highAt ? low : high);
+		if (lowAt != highAt)
+			envelope.push_back(lowAt <= highAt ? high : low);
+	}
+}
+
+// a block of the pyramid as its extrema in the order they came, at the x of its first and last sample
+static void AddSummary(ImVector<ImVec2>& points, const PlotSummary& block)
+{
+	points.push_back(ImVec2(block.X0, block.MaxFirst ? block.Max : block.Min));
+	points.push_back(ImVec2(block.X1, block.MaxFirst ? block.Min : block.Max));
+}
+
+// the samples of the buffer within the x limits from the given level of its pyramid: the blocks of the level are
+// found by binary search (the x of the samples only ever grows or only ever shrinks), the newest samples that are not
+// in a block of the level yet are taken from the levels below, down to the samples themselves.
+// at most a block of the level per point, plus PLOT_PYRAMID_FACTOR per level below
+static void GatherPyramid(ImVector<ImVec2>& points, const ScrollingBuffer& buffer, int level, const ImPlotRect& limits)
+{
+	const PlotPyramid& pyramid = buffer.Pyramid;
+	points.resize(0);
+	const unsigned int first = pyramid.First(level);
+	const unsigned int end = pyramid.Levels[level].Count;
+	if (first < end) {
+		// in keys that grow with the blocks
+		const float direction = pyramid.Get(level, end - 1).X0 >= pyramid.Get(level, first).X0 ? 1.0f : -1.0f;
+		const double low = direction > 0.0f ? limits.X.Min : -limits.X.Max;
+		const double high = direction > 0.0f ? limits.X.Max : -limits.X.Min;
+		unsigned int from = first, to = end;
+		while (from < to) {
+			// the first block that ends at or past low
+			const unsigned int mid = from + (to - from) / 2;
+			if (direction * pyramid.Get(level, mid).X1 < low)
+				from = mid + 1;
+			else
+				to = mid;
+		}
+		unsigned int last = end;
+		to = from;
+		while (to < last) {
+			// the first block that starts past high
+			const unsigned int mid = to + (last - to) / 2;
+			if (direction * pyramid.Get(level, mid).X0 <= high)
+				to = mid + 1;
+			else
+				last = mid;
+		}
+		// one block to each side, the line leaves the plot through them
+		from = from > first ? from - 1 : first;
+		to = to < end ? to + 1 : end;
+		for (unsigned int b = from; b < to; b++)
+			AddSummary(points, pyramid.Get(level, b));
+	}
+	for (int k = level - 1; k >= 0; k--) {
+		const unsigned int count = pyramid.Levels[k].Count;
+		for (int b = pyramid.Levels[k + 1].Filled; b > 0; b--)
+			AddSummary(points, pyramid.Get(k, count - b));
+	}
+	const int size = buffer.Data.Size;
+	for (int i = pyramid.Levels[0].Filled; i > 0; i--)
+		points.push_back(buffer.Data[(buffer.Offset + size - i) % size]);
+}
+
+// plots a scrolling buffer as a line, reduced to the min/max envelope of every pixel column of the plot once there are
+// more than PLOT_POINTS_PER_PIXEL samples per column. a buffer with a pyramid is drawn from its coarsest level that
+// still has a block per column, so the cost stays bounded by the width of the plot however long the history is.
+// the x of a scrolling plot is its time, so it only ever grows or only ever shrinks: implot renders the visible slice.
+// an axis that is being fit needs all samples, it gets them unreduced
+static void PlotScrolling(const char* label, const ScrollingBuffer& buffer)
+{
+	static ImVector<ImVec2> envelope;
+	static ImVector<ImVec2> summaries;
+	const int size = buffer.Data.Size;
+	if (size == 0)
+		return;
+
+	const ImPlotRect limits = ImPlot::GetPlotLimits();
+	const float width = ImPlot::GetPlotSize().x;
+	if (size <= PLOT_POINTS_PER_PIXEL * width || width < 1.0f || limits.X.Size() <= 0.0 || ImPlot::FitThisFrame()) {
+		ImPlot::SetNextLineMonotonicX();
+		ImPlot::PlotLine(label, &buffer.Data[0].x, &buffer.Data[0].y, size, buffer.Offset, sizeof(ImVec2));
+		return;
+	}
+
+	// the samples per column, the samples are about evenly spaced in x
+	int level = -1;
+	const float span = fabsf(buffer.Newest().x - buffer.Data[buffer.Offset].x);
+	if (!buffer.Pyramid.Levels.empty() && span > 0.0f) {
+		const double perColumn = limits.X.Size() / width * (size - 1) / span;
+		while (level + 1 < static_cast<int>(buffer.Pyramid.Levels.size()) && PlotPyramid::BlockSize(level + 1) <= perColumn)
+			level++;
+	}
+
+	if (level >= 0) {
+		GatherPyramid(summaries, buffer, level, limits);
+		ReduceToEnvelope(envelope, summaries.Data, summaries.Size, 0, limits, width);
+	}
+	else
+		ReduceToEnvelope(envelope, buffer.Data.Data, size, buffer.Offset, limits, width);
+	if (envelope.Size > 0) {
+		ImPlot::SetNextLineMonotonicX();
+		ImPlot::PlotLine(label, &envelope[0].x, &envelope[0].y, envelope.Size, 0, sizeof(ImVec2));
+	}
+}
+
 void fourier::DrawCanvas()
 {
 	ImGui::Begin("Canvas");
@@ -217,23 +513,36 @@ void fourier::DrawCanvas()
 	if (opt_enable_image || concept_current == 5)
 		DrawBackground(draw_list, image_pos);
 
+	// the captured path is simplified while it is drawn, only the points that shape it go into the result (and the dft)
+	ImVec2 kept;
+
 	// Add first and second point
 	if (is_hovered && !stop_capture && ImGui::IsMouseClicked(ImGuiMouseButton_Left))
 	{
-		points.push_back(mouse_pos_in_canvas);
-		// need to add temporary point that will be replaced in the next if statement by the most current mouse cursor's position
+		if (points.size() > 0 && captureSimplifier.Flush(kept))
+		{
+			points.push_back(kept);
+			result.AddPoint(kept.x, kept.y);
+		}
 		points.push_back(mouse_pos_in_canvas);
 		result.AddPoint(mouse_pos_in_canvas.x, mouse_pos_in_canvas.y);
+		captureSimplifier.Reset();
+		captureSimplifier.Add(mouse_pos_in_canvas, kept);
 	}
 
-	if (points.size() > 0 && !stop_capture)
+	if (points.size() > 0 && !stop_capture && captureSimplifier.Add(mouse_pos_in_canvas, kept))
 	{
-		points.push_back(mouse_pos_in_canvas);
-		result.AddPoint(mouse_pos_in_canvas.x, mouse_pos_in_canvas.y);
+		points.push_back(kept);
+		result.AddPoint(kept.x, kept.y);
 	}
 
 	if (is_hovered && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left))
 	{
+		if (!stop_capture && captureSimplifier.Flush(kept))
+		{
+			points.push_back(kept);
+			result.AddPoint(kept.x, kept.y);
+		}
 		stop_capture = true;
 	}
 
@@ -244,7 +553,7 @@ void fourier::DrawCanvas()
 	{
 		scrolling.x += io.MouseDelta.x;
 		scrolling.y += io.MouseDelta.y;
-		tracer.Erase();
+		EraseTrace();
 	}
 
 	// Context menu (under default mouse threshold)
@@ -262,6 +571,7 @@ void fourier::DrawCanvas()
 			points.clear();
 			stop_capture = false;
 			result.Erase();
+			captureSimplifier.Reset();
 		}
 		ImGui::EndPopup();
 	}
@@ -282,6 +592,8 @@ void fourier::DrawCanvas()
 	for (int n = 0; n < points.Size; n += 1)
 		if (n + 1 < points.Size)
 			draw_list->AddLine(ImVec2(origin.x + points[n].x, origin.y + points[n].y), ImVec2(origin.x + points[n + 1].x, origin.y + points[n + 1].y), IM_COL32(155, 55, 55, 255), 4.0f);
+	if (points.Size > 0 && !stop_capture) // the live end, not kept (yet)
+		draw_list->AddLine(ImVec2(origin.x + points.back().x, origin.y + points.back().y), ImVec2(origin.x + captureSimplifier.Last.x, origin.y + captureSimplifier.Last.y), IM_COL32(155, 55, 55, 255), 4.0f);
 #pragma endregion init_canvas
 
 	if (concept_current == 5) // we are done here, capture path of image only
@@ -296,6 +608,21 @@ void fourier::DrawCanvas()
 	ImVec2 circle_pos = ImVec2(canvas_p0.x + (canvas_sz.x / 2) + scrolling.x, canvas_p0.y + (canvas_sz.y / 2) + scrolling.y);
 	ImVec2 tip, e1, e2, ec;
 
+	// the previous spectrum is drawn until the worker publishes the new one, the trace restarts with it
+	std::shared_ptr<const Spectrum> spectrum = spectrumWorker.Get();
+	if (spectrum && spectrum->generation != spectrumGeneration)
+	{
+		spectrumGeneration = spectrum->generation;
+		if (concept_current >= 3)
+		{
+			EraseTrace();
+			time = 0.0f;
+		}
+	}
+	static const Spectrum empty;
+	const Spectrum& dft = spectrum ? *spectrum : empty;
+	culledEpicycles = 0;
+
 	switch (concept_current) {
 	case 0: // fourier series
 		waveletGenerator.DrawWavelets(draw_list, time, circle_pos, showCircles, showEdges);
@@ -312,24 +639,34 @@ void fourier::DrawCanvas()
 		waveletGenerator.DrawWavelet(log, draw_list, plotTimeChangeRate, 0, dataModulated, demodulator, result, numNodes, circle_pos, showCircles, showEdges);
 		break;
 	case 3: //dft 2 epicycles
-		e2 = DrawEpiCycles(origin.x, origin.y, 0.0f, Xdft, time);
-		e1 = DrawEpiCycles(origin.x, origin.y, PI / 2.0f, Ydft, time);
-
+		if (dft.pathXY.empty())
+			break;
+		// the tip is looked up in the precomputed path, the epicycles are only evaluated when they are drawn
+		tip = SamplePath(dft.pathXY, time);
+		if (showCircles || showEdges)
+		{
+			e2 = DrawEpiCycles(origin.x, origin.y, 0.0f, dft.Xdft, time);
+			e1 = DrawEpiCycles(origin.x, origin.y, PI / 2.0f, dft.Ydft, time);
+		}
 		if (showEdges)
 		{
 			draw_list->AddLine(ImVec2(e1.x, e1.y), ImVec2(e2.x, e1.y), IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
 			draw_list->AddLine(ImVec2(e2.x, e2.y), ImVec2(e2.x, e1.y), IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
 		}
-		tracer.AddPoint(e2.x - circle_pos.x, e1.y - circle_pos.y);
+		AddTracePoint(ImVec2(origin.x + tip.x - circle_pos.x, origin.y + tip.y - circle_pos.y));
 		break;
 	case 4: //dft 1 epicycle
-		ec = DrawEpiCycles(origin.x, origin.y, 0.0f, Cdft, time);
-		tracer.AddPoint(ec.x - circle_pos.x, ec.y - circle_pos.y);
+		if (dft.pathC.empty())
+			break;
+		tip = SamplePath(dft.pathC, time);
+		if (showCircles || showEdges)
+			ec = DrawEpiCycles(origin.x, origin.y, 0.0f, dft.Cdft, time);
+		AddTracePoint(ImVec2(origin.x + tip.x - circle_pos.x, origin.y + tip.y - circle_pos.y));
 		break;
 	}
 
 	if (concept_current >= 3)
-		time += static_cast<float>(TWO_PI / Cdft.size());
+		time += dft.numSamples == 0 ? 0.0f : static_cast<float>(TWO_PI / dft.numSamples);
 	else
 		time += static_cast<float>(TWO_PI / timeChangeRate);
 
@@ -341,34 +678,28 @@ void fourier::DrawCanvas()
 		if (concept_current < 3)
 		{
 			if (tracer.Data.Size > 0)
-				tracer.AddPoint(waveletGenerator.GetFinalTip().x, waveletGenerator.GetFinalTip().y);
+				AddTracePoint(waveletGenerator.GetFinalTip());
 			else
 				tracer.AddPoint(0.0f, 0.0f);
 		}
-		ImVec2 p = { 0.0f, 0.0f };
-
 
-		for (int n = 1; n < tracer.Data.Size; n += 1)
-			if (n + 1 < tracer.Data.Size)
-				draw_list->AddLine(ImVec2(circle_pos.x + tracer.Data[n].x, circle_pos.y + tracer.Data[n].y),
-					ImVec2(circle_pos.x + tracer.Data[n + 1].x, circle_pos.y + tracer.Data[n + 1].y),
-					IM_COL32(20, 125, 225, 255), 2.0f);
+		// the first sample of the wavelets is the origin until the trace wraps arround
+		const int first = concept_current < 3 && tracer.Data.Size < tracer.MaxSize ? 1 : 0;
+		DrawTrace(draw_list, tracer, first, circle_pos, showTracePoints, traceBudget, IM_COL32(20, 125, 225, 255));
 
-		for (int i = 0; i < tracer.Data.size(); i++)
+		// the live end of the trace, from the newest kept sample to the tip
+		if (tracer.Data.Size > 0)
 		{
-			p = ImVec2(tracer.Data[i].x + circle_pos.x, tracer.Data[i].y + circle_pos.y);
-			if (i == 0 && concept_current != 4)
-			{
-				draw_list->AddCircle(p, 5.0f, IM_COL32(255, 20, 125, 255), 0, 2.0f);
-			}
-			else
-			{
-				draw_list->AddCircle(p, 1.0f, IM_COL32(20, 125, 225, 255), 0, 1.0f);
-			}
+			const ImVec2 newest = tracer.Newest();
+			draw_list->AddLine(ImVec2(newest.x + circle_pos.x, newest.y + circle_pos.y), ImVec2(traceSimplifier.Last.x + circle_pos.x, traceSimplifier.Last.y + circle_pos.y), IM_COL32(20, 125, 225, 255), 2.0f);
 		}
 
-		if (concept_current != 4)
-			draw_list->AddCircle(p, 3.0f, IM_COL32(255, 20, 125, 255), 0, 2.0f);
+		if (tracer.Data.Size > 0 && concept_current != 4)
+		{
+			const ImVec2 oldest = tracer.Data[tracer.Offset];
+			draw_list->AddCircle(ImVec2(oldest.x + circle_pos.x, oldest.y + circle_pos.y), 5.0f, IM_COL32(255, 20, 125, 255), 0, 2.0f);
+			draw_list->AddCircle(ImVec2(traceSimplifier.Last.x + circle_pos.x, traceSimplifier.Last.y + circle_pos.y), 3.0f, IM_COL32(255, 20, 125, 255), 0, 2.0f);
+		}
 	}
 
 	if (concept_current != 4)
@@ -395,7 +726,8 @@ void fourier::DrawProperties()
 	// Create a window called "Properties" and append into it.
 	ImGui::Begin("Properties");
 	ImGui::Checkbox("Draw Circles", &showCircles); ImGui::SameLine();
-	ImGui::Checkbox("Draw Edges", &showEdges);
+	ImGui::Checkbox("Draw Edges", &showEdges); ImGui::SameLine();
+	ImGui::Checkbox("Draw Trace Points", &showTracePoints);
 	if (concept_current == 0)
 	{
 		ImGui::SameLine();
@@ -404,7 +736,22 @@ void fourier::DrawProperties()
 			waveletGenerator.EnableAlternateSeries(isAlternateSeries);
 			updateRequired = true;
 		}
+		ImGui::SameLine();
+		if (ImGui::Checkbox("Use Rotors", &isRotorMode))
+			waveletGenerator.EnableRotors(isRotorMode);
+		if (strategy_current <= 2)
+		{
+			ImGui::SameLine();
+			updateRequired = ImGui::Checkbox("Use Synthesis", &isSynthesisMode) || updateRequired;
+			if (isSynthesisMode && ImGui::InputInt("Harmonics", &numHarmonics, 1000, 100000, ImGuiInputTextFlags_EnterReturnsTrue))
+			{
+				numHarmonics = numHarmonics < 1 ? 1 : (numHarmonics > MAX_HARMONICS ? MAX_HARMONICS : numHarmonics);
+				updateRequired = true;
+			}
+		}
 	}
+	if (ImGui::Combo("Drawing Trigonometry", &sincos_current, sincosTiers, IM_ARRAYSIZE(sincosTiers)))
+		waveletGenerator.SetSinCosTier(static_cast<SinCos::Tier>(sincos_current));
 
 	ImGui::Separator();
 	updateRequired = ImGui::ListBox("Concepts", &concept_current, concepts, IM_ARRAYSIZE(concepts), 3) || updateRequired;
@@ -417,15 +764,42 @@ void fourier::DrawProperties()
 		changed_curve = ImGui::ListBox("Curve", &curve_current, curves, IM_ARRAYSIZE(curves), 3);
 	}
 	updateRequired = changed_curve || updateRequired;
+	if (concept_current == 3 || concept_current == 4)
+	{
+		updateRequired = ImGui::ListBox("Coefficients", &selection_current, selections, IM_ARRAYSIZE(selections), 4) || updateRequired;
+		if (selection_current == 2)
+			updateRequired = ImGui::SliderFloat("Energy Fraction", &energyFraction, 0.9f, 1.0f, "%.4f") || updateRequired;
+		if (selection_current == 3)
+			updateRequired = ImGui::SliderFloat("RMS Error", &rmsError, 0.01f, 20.0f, "%.2f") || updateRequired;
+	}
 	ImGui::Separator();
 
 	//if (strategy_current < 4 && concept_current != 1) // primes have set number of nodes, ie slider does not do anything for primes series
-	updateRequired = ImGui::SliderInt("Num of Nodes", &numNodes, 1, MAX_NODES) || updateRequired;
+	// the fourier series is evaluated in one batch and takes far more nodes than the other concepts
+	// the strategies of a sequence take no more nodes than its table holds
+	int maxNodes = concept_current == 0 ? MAX_SERIES_NODES : MAX_NODES;
+	if (concept_current == 0 && strategy_current >= 3 && strategy_current <= 9)
+		maxNodes = Sequences::GetLength(StrategySequence(strategy_current));
+	if (numNodes > maxNodes)
+	{
+		numNodes = maxNodes;
+		updateRequired = true;
+	}
+	const bool nodesChanged = ImGui::SliderInt("Num of Nodes", &numNodes, 1, maxNodes, "%d", concept_current == 0 ? ImGuiSliderFlags_Logarithmic : ImGuiSliderFlags_None);
+	// the demodulation winds the data numNodes times, it starts over with another count
+	updateRequired = (nodesChanged && concept_current == 2) || updateRequired;
 
 	//if (concept_current != 2) // primes have set number of nodes, ie slider does not do anything for primes series
 	updateRequired = ImGui::SliderFloat("Slowmo Rate Canvas", &timeChangeRate, 10.0f, 10000.0f) || updateRequired;
 	updateRequired = ImGui::SliderFloat("Slowmo Rate Plot", &plotTimeChangeRate, 10.0f, 10000.0f) || updateRequired;
-	updateRequired = ImGui::SliderFloat("Radius", &radiusCircle, 2.0f, 512.0f /*65536.0f*/) || updateRequired;
+	const bool radiusChanged = ImGui::SliderFloat("Radius", &radiusCircle, 2.0f, 512.0f /*65536.0f*/);
+	// the frequencies of the custom strategy are scaled by the radius and the synthesized series draws the wavelets of
+	// at least half a pixel, neither follows a rescale of the radii, they are rebuilt
+	updateRequired = (radiusChanged && concept_current == 0 && (strategy_current == 10 || (isSynthesisMode && strategy_current <= 2))) || updateRequired;
+	ImGui::SliderInt("Trace Vertex Budget", &traceBudget, 1000, 1000000, "%d", ImGuiSliderFlags_Logarithmic);
+	ImGui::SliderFloat("Simplify Tolerance", &simplifyTolerance, 0.0f, 4.0f, "%.2f px");
+	traceSimplifier.Tolerance = simplifyTolerance;
+	captureSimplifier.Tolerance = simplifyTolerance;
 	ImGui::Separator();
 
 	ImGui::ColorEdit3("Clear Color", (float*)&clear_color); // Edit 3 floats representing a color
@@ -433,6 +807,41 @@ void fourier::DrawProperties()
 	ImGui::Separator();
 	ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
 	ImGui::Text("Time %.3f", time);
+	ImGui::Text("FFT kernels %s", FFTKernels::Get().name);
+	ImGui::Text("Wavelet kernels %s", WaveletKernels::Get().name);
+	ImGui::Text("Trace kept %d of %d, path kept %d of %d", traceSimplifier.Kept, traceSimplifier.Added, captureSimplifier.Kept, captureSimplifier.Added);
+	if (concept_current == 0)
+		ImGui::Text("Culled circles %d of %d", waveletGenerator.GetCulled(), waveletGenerator.GetSize());
+	else if (concept_current == 3 || concept_current == 4)
+		ImGui::Text("Culled epicycles %d", culledEpicycles);
+	if (ImGui::TreeNode("Trigonometry vs libm"))
+	{
+		static SinCos::Accuracy report[SinCos::TierCount];
+		static bool measured = false;
+		if (!measured || ImGui::Button("Measure"))
+		{
+			for (int i = 0; i < SinCos::TierCount; i++)
+				report[i] = SinCos::Measure(static_cast<SinCos::Tier>(i));
+			measured = true;
+		}
+		for (int i = 0; i < SinCos::TierCount; i++)
+			ImGui::Text("%-5s max %.1e rms %.1e, %.1f ns scalar %.1f ns batch", SinCos::GetName(static_cast<SinCos::Tier>(i)), report[i].maxError, report[i].rmsError, report[i].nsScalar, report[i].nsBatch);
+		ImGui::TreePop();
+	}
+	if (spectrumWorker.IsBusy())
+		ImGui::Text("Updating spectrum ...");
+	std::shared_ptr<const Spectrum> spectrum = spectrumWorker.Get();
+	if (spectrum && (concept_current == 3 || concept_current == 4))
+	{
+		// reconstruction error of the drawn coefficients vs. the captured path (parseval)
+		const bool pair = concept_current == 3;
+		const size_t kept = pair ? spectrum->Xdft.size() + spectrum->Ydft.size() : spectrum->Cdft.size();
+		const size_t total = pair ? 2 * spectrum->numSamples : spectrum->numSamples;
+		ImGui::Text("Coefficients %zu of %zu", kept, total);
+		ImGui::Text("RMS error %.3f, energy kept %.4f%%", pair ? spectrum->rmsErrorXY : spectrum->rmsErrorC, 100.0 * (pair ? spectrum->energyKeptXY : spectrum->energyKeptC));
+		if (pair ? spectrum->cappedXY : spectrum->cappedC)
+			ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Bound not met, it needs more than %d coefficients", MAX_NODES);
+	}
 	ImGui::End();
 
 	if (updateRequired)
@@ -450,7 +859,24 @@ void fourier::DrawProperties()
 
 		if (concept_current != 2)
 			dataAnalog[2].Erase(); // holds temporary data for further analysis that needs to be removed now
+	}
+	else if (nodesChanged || radiusChanged)
+	{
+		// the node count and the radius are changed in place, so scrubbing them keeps the frame rate.
+		// the trace starts over with the new shape, the epicycles restart once their selection is published
+		if (concept_current < 3)
+			EraseTrace();
+		if (radiusChanged)
+			waveletGenerator.SetRadius(radiusCircle);
+		if (nodesChanged)
+		{
+			ResizeWavelets();
+			RequestSpectrum();
+		}
+	}
 
+	if (updateRequired || nodesChanged || radiusChanged)
+	{
 		log.AddLog("[%.1f] - strategy: %d - nodes: %d  - slomo rate: %.1f - radius: %.1f - alternate series: %s\n",
 			ImGui::GetTime(), strategy_current, numNodes, timeChangeRate, radiusCircle, isAlternateSeries ? "true" : "false");
 	}
@@ -612,8 +1038,7 @@ void fourier::DrawPlotsDemodulate(bool& open)
 	ImGui::Checkbox("sin(x)-cos(x)", &showAnalog[5]);
 
 	double range = TWO_PI;
-	float minY = 100.0f;
-	float maxY = 0.0f;
+	dataModulated.SetWindow(dataModulated.MaxSize);
 
 	finalY = 0.0f;
 	finalX = 0.0f;
@@ -657,7 +1082,7 @@ void fourier::DrawPlotsDemodulate(bool& open)
 			for (int i = 1; i < (numNodes + 1); i++)
 			{
 				tmp = (i * 2.0f);
-				finalY += static_cast<float>((4 * sin(x * tmp)) / (PI * tmp));
+				finalY += static_cast<float>((4 * SinCos::Sin(SinCos::Exact, x * tmp)) / (PI * tmp));
 			}
 
 			break;
@@ -666,7 +1091,7 @@ void fourier::DrawPlotsDemodulate(bool& open)
 			for (int i = 1; i < (numNodes + 1); i++)
 			{
 				tmp = (i * 2.0f) - 1.0f;
-				finalY += static_cast<float>((4 * sin(x * tmp)) / (PI * tmp));
+				finalY += static_cast<float>((4 * SinCos::Sin(SinCos::Exact, x * tmp)) / (PI * tmp));
 			}
 			break;
 		case 12: // square
@@ -714,7 +1139,7 @@ void fourier::DrawPlotsDemodulate(bool& open)
 			for (int i = 1; i < (numNodes + 1); i++)
 			{
 				tmp = static_cast<float>(i);
-				finalY += i % 2 ? sin(x * tmp) : -sin(x * tmp);
+				finalY += static_cast<float>(i % 2 ? SinCos::Sin(SinCos::Exact, x * tmp) : -SinCos::Sin(SinCos::Exact, x * tmp));
 			}
 			break;
 		case 14://	"-sin(x)  + sin(2x) - sin(3x) + sin(4x) - sin(5x)....",
@@ -722,7 +1147,7 @@ void fourier::DrawPlotsDemodulate(bool& open)
 			for (int i = 1; i < (numNodes + 1); i++)
 			{
 				tmp = static_cast<float>(i);
-				finalY += !(i % 2) ? sin(x * tmp) : -sin(x * tmp);
+				finalY += static_cast<float>(!(i % 2) ? SinCos::Sin(SinCos::Exact, x * tmp) : -SinCos::Sin(SinCos::Exact, x * tmp));
 			}
 			break;
 		case 15://"dataAnalog[2]"
@@ -732,9 +1157,6 @@ void fourier::DrawPlotsDemodulate(bool& open)
 			break;
 		}
 
-		minY = IM_MIN(minY, finalY);
-		maxY = IM_MAX(maxY, finalY);
-
 		x += range / dataModulated.MaxSize;
 
 		dataModulated.AddPoint(x, finalY);
@@ -743,10 +1165,10 @@ void fourier::DrawPlotsDemodulate(bool& open)
 	ImVec2 region = ImVec2(ImGui::GetContentRegionAvail().x, ImGui::GetContentRegionAvail().y / 2.0f);
 	if (ImPlot::BeginPlot("##Digital", region)) {
 		ImPlot::SetupAxisLimits(ImAxis_X1, 0, range, ImGuiCond_Always);
-		ImPlot::SetupAxisLimits(ImAxis_Y1, minY - 0.5f, maxY + 0.5f);
+		ImPlot::SetupAxisLimits(ImAxis_Y1, dataModulated.MinY() - 0.5f, dataModulated.MaxY() + 0.5f);
 		strcpy_s(label, 32, "Curve");
 		if (dataModulated.Data.size() > 0)
-			ImPlot::PlotLine(label, &dataModulated.Data[0].x, &dataModulated.Data[0].y, dataModulated.Data.size(), dataModulated.Offset, 2 * sizeof(float));
+			PlotScrolling(label, dataModulated);
 		ImPlot::EndPlot();
 	}
 
@@ -760,37 +1182,37 @@ void fourier::DrawPlotsDemodulate(bool& open)
 		{
 			strcpy_s(label, 32, "cos(x)");
 			if (demodulator[0].Data.size() > 0)
-				ImPlot::PlotLine(label, &demodulator[0].Data[0].x, &demodulator[0].Data[0].y, demodulator[0].Data.size(), demodulator[0].Offset, 2 * sizeof(float));
+				PlotScrolling(label, demodulator[0]);
 		}
 		if (showAnalog[1])
 		{
 			strcpy_s(label, 32, "sin(x)");
 			if (demodulator[1].Data.size() > 0)
-				ImPlot::PlotLine(label, &demodulator[1].Data[0].x, &demodulator[1].Data[0].y, demodulator[1].Data.size(), demodulator[1].Offset, 2 * sizeof(float));
+				PlotScrolling(label, demodulator[1]);
 		}
 		if (showAnalog[2])
 		{
 			strcpy_s(label, 32, "magnitude");
 			if (demodulator[2].Data.size() > 0)
-				ImPlot::PlotLine(label, &demodulator[2].Data[0].x, &demodulator[2].Data[0].y, demodulator[2].Data.size(), demodulator[2].Offset, 2 * sizeof(float));
+				PlotScrolling(label, demodulator[2]);
 		}
 		if (showAnalog[3])
 		{
 			strcpy_s(label, 32, "-magnitude");
 			if (demodulator[3].Data.size() > 0)
-				ImPlot::PlotLine(label, &demodulator[3].Data[0].x, &demodulator[3].Data[0].y, demodulator[3].Data.size(), demodulator[3].Offset, 2 * sizeof(float));
+				PlotScrolling(label, demodulator[3]);
 		}
 		if (showAnalog[4])
 		{
 			strcpy_s(label, 32, "sin(x)+cos(x)");
 			if (demodulator[4].Data.size() > 0)
-				ImPlot::PlotLine(label, &demodulator[4].Data[0].x, &demodulator[4].Data[0].y, demodulator[4].Data.size(), demodulator[4].Offset, 2 * sizeof(float));
+				PlotScrolling(label, demodulator[4]);
 		}
 		if (showAnalog[5])
 		{
 			strcpy_s(label, 32, "sin(x)-cos(x)");
 			if (demodulator[5].Data.size() > 0)
-				ImPlot::PlotLine(label, &demodulator[5].Data[0].x, &demodulator[5].Data[0].y, demodulator[5].Data.size(), demodulator[5].Offset, 2 * sizeof(float));
+				PlotScrolling(label, demodulator[5]);
 		}
 		ImPlot::EndPlot();
 	}
@@ -798,6 +1220,25 @@ void fourier::DrawPlotsDemodulate(bool& open)
 }
 
 
+// the samples of a scrolling plot that fit into its 10 units of time
+static int ScrollingWindow(float step)
+{
+	return static_cast<int>(10.0f / step) + 1;
+}
+
+// the extrema of the shown scrolling plots within their windows, 0 when there is nothing to show
+static void ScrollingExtrema(const ScrollingBuffer* plots, const bool* shown, float& min, float& max)
+{
+	bool found = false;
+	for (int i = 0; i < 2; i++) {
+		if (!shown[i] || plots[i].Data.Size == 0 || plots[i].Window == 0)
+			continue;
+		min = found ? IM_MIN(min, plots[i].MinY()) : plots[i].MinY();
+		max = found ? IM_MAX(max, plots[i].MaxY()) : plots[i].MaxY();
+		found = true;
+	}
+}
+
 void fourier::DrawPlotsCaptureScrolling(bool& open)
 {
 	ImGui::Begin("DigitalPlots", &open);
@@ -806,52 +1247,39 @@ void fourier::DrawPlotsCaptureScrolling(bool& open)
 	static bool showAnalog[2] = { true, true };
 	static bool flipSign = false;
 	static float prevX = 1.0f;
-	static float min = 0.0f;
-	static float max = 1.0f;
 
 	char label[32];
 	ImGui::Checkbox("real", &showAnalog[0]);  ImGui::SameLine();
 	ImGui::Checkbox("imag", &showAnalog[1]);
 
+	const int window = ScrollingWindow(static_cast<float>(PI / plotTimeChangeRate));
+	dataAnalog[0].SetWindow(window);
+	dataAnalog[1].SetWindow(window);
+
 	if (!paused) {
 		timePlot += static_cast<float>(PI / plotTimeChangeRate); //ImGui::GetIO().DeltaTime;
 		int len = points.size();
+		const ImVec2 pen = captureSimplifier.Last; // the mouse, the newest captured point may lag behind
 		if (showAnalog[0] && len > 0)
-		{
-			dataAnalog[0].AddPoint(-timePlot, points[len-1].x);
-			if (points[len - 1].x > max)
-				max = points[len - 1].x;
-			if (points[len - 1].x < min)
-				min = points[len - 1].x;
-		}
-		else
-		{
-			min = 0.0f;
-			max = 0.0f;
-			min = 0.0f;
-			max = 0.0f;
-		}
+			dataAnalog[0].AddPoint(-timePlot, pen.x);
 		if (showAnalog[1] && len > 0)
-		{
-			dataAnalog[1].AddPoint(-timePlot, points[len - 1].y);
-			if (points[len - 1].y > max)
-				max = points[len - 1].y;
-			if (points[len - 1].y < min)
-				min = points[len - 1].y;
-		}
+			dataAnalog[1].AddPoint(-timePlot, pen.y);
 
 		if(len > 0)
-			dataAnalog[2].AddPoint(points[len - 1].x / 100.0f, points[len - 1].y / 100.0f); // for demodulation concept
+			dataAnalog[2].AddPoint(pen.x / 100.0f, pen.y / 100.0f); // for demodulation concept
 	}
 
 	if (ImPlot::BeginPlot("##Digital", ImGui::GetContentRegionAvail())) {
 		ImPlot::SetupAxisLimits(ImAxis_X1, -timePlot + 10.0, -timePlot, paused ? ImGuiCond_Once : ImGuiCond_Always);
+		float min = 0.0f;
+		float max = 0.0f;
+		ScrollingExtrema(dataAnalog, showAnalog, min, max);
 		ImPlot::SetupAxisLimits(ImAxis_Y1, min, max, paused ? ImGuiCond_Once : ImGuiCond_Always);
 		for (int i = 0; i < 2; ++i) {
 			if (showAnalog[i]) {
 				strcpy_s(label, 32, i ? "real" : "imag");
 				if (dataAnalog[i].Data.size() > 0)
-					ImPlot::PlotLine(label, &dataAnalog[i].Data[0].x, &dataAnalog[i].Data[0].y, dataAnalog[i].Data.size(), dataAnalog[i].Offset, 2 * sizeof(float));
+					PlotScrolling(label, dataAnalog[i]);
 			}
 		}
 		ImPlot::EndPlot();
@@ -867,44 +1295,37 @@ void fourier::DrawPlotsEpiCyclesScrolling(bool& open)
 	static bool showAnalog[2] = { true, true };
 	static bool flipSign = false;
 	static float prevX = 1.0f;
-	static float min = 100000.0f;
-	static float max = -100000.0f;
 
 	char label[32];
 	ImGui::Checkbox("x", &showAnalog[0]);  ImGui::SameLine();
 	ImGui::Checkbox("y", &showAnalog[1]);
 
+	const int window = ScrollingWindow(static_cast<float>(PI / plotTimeChangeRate));
+	dataAnalog[0].SetWindow(window);
+	dataAnalog[1].SetWindow(window);
+
 	int len = tracer.Data.Size;
-	ImVec2 finalTip = len > 0 ? ImVec2(tracer.Data[len - 1].x, tracer.Data[len - 1].y) : ImVec2();
+	ImVec2 finalTip = len > 0 ? traceSimplifier.Last : ImVec2();
 
 	if (!paused) {
 		timePlot += static_cast<float>(PI / plotTimeChangeRate); //ImGui::GetIO().DeltaTime;
 		if (showAnalog[0])
-		{
 			dataAnalog[0].AddPoint(-timePlot, -finalTip.x);
-			if (-finalTip.x > max)
-				max = -finalTip.x;
-			if (-finalTip.x < min)
-				min = -finalTip.x;
-		}
 		if (showAnalog[1])
-		{
 			dataAnalog[1].AddPoint(-timePlot, -finalTip.y);
-			if (-finalTip.y > max)
-				max = -finalTip.y;
-			if (-finalTip.y < min)
-				min = -finalTip.y;
-		}
 	}
 
 	if (ImPlot::BeginPlot("##Digital", ImGui::GetContentRegionAvail())) {
 		ImPlot::SetupAxisLimits(ImAxis_X1, -timePlot + 10.0, -timePlot, paused ? ImGuiCond_Once : ImGuiCond_Always);
+		float min = 0.0f;
+		float max = 0.0f;
+		ScrollingExtrema(dataAnalog, showAnalog, min, max);
 		ImPlot::SetupAxisLimits(ImAxis_Y1, min - 1.0f, max + 1.0f, paused ? ImGuiCond_Once : ImGuiCond_Always);
 		for (int i = 0; i < 2; ++i) {
 			if (showAnalog[i]) {
 				strcpy_s(label, 32, i ? "imag" : "real");
 				if (dataAnalog[i].Data.size() > 0)
-					ImPlot::PlotLine(label, &dataAnalog[i].Data[0].x, &dataAnalog[i].Data[0].y, dataAnalog[i].Data.size(), dataAnalog[i].Offset, 2 * sizeof(float));
+					PlotScrolling(label, dataAnalog[i]);
 			}
 		}
 		ImPlot::EndPlot();
@@ -913,63 +1334,94 @@ void fourier::DrawPlotsEpiCyclesScrolling(bool& open)
 }
 
 
-void fourier::DrawPlotsTransformScrolling(bool& open) {
-	ImGui::Begin("DigitalPlots", &open);
-
-	static bool paused = false;
-	static bool showAnalog[2] = { true, true };
-	static bool flipSign = false;
-	static float prevX = 1.0f;
-
-	char label[32];
-	ImGui::Checkbox("cos(x)", &showAnalog[0]);  ImGui::SameLine();
-	ImGui::Checkbox("sin(x)", &showAnalog[1]);
-
-	switch (curve_current) {
+// the live transform: y is the curve at t, x its derivative
+static ImVec2 EvaluateCurve(int curve, double t)
+{
+	double x = 0.0;
+	double y = 0.0;
+	switch (curve) {
 	case 0: // cos(x)
-		finalY = sin(timePlot);
-		finalX = cos(timePlot);
+		y = sin(t);
+		x = cos(t);
 		break;
 	case 1: // cos(x)
-		finalY = cos(timePlot);
-		finalX = -sin(timePlot);
+		y = cos(t);
+		x = -sin(t);
 		break;
 	case 2: //sin(x)^2 + cos(x)
-		finalY = (sin(timePlot) * sin(timePlot)) + cos(timePlot);
-		finalX = 2 * (sin(timePlot) * cos(timePlot)) - sin(timePlot);
+		y = (sin(t) * sin(t)) + cos(t);
+		x = 2 * (sin(t) * cos(t)) - sin(t);
 		break;
 	case 3: // cos(x)sin(x)+sin(x)cos(x)
-		finalY = (cos(timePlot) * sin(timePlot)) + (sin(timePlot) * cos(timePlot));
-		finalX = (-sin(timePlot) * sin(timePlot)) + (cos(timePlot) * cos(timePlot)) + (-sin(timePlot) * sin(timePlot)) + (cos(timePlot) * cos(timePlot));
+		y = (cos(t) * sin(t)) + (sin(t) * cos(t));
+		x = (-sin(t) * sin(t)) + (cos(t) * cos(t)) + (-sin(t) * sin(t)) + (cos(t) * cos(t));
 		break;
 	case 4: //"sin(2x)",
-		finalY = sin(2 * timePlot);
-		finalX = 2 * cos(2 * timePlot);
+		y = sin(2 * t);
+		x = 2 * cos(2 * t);
 		break;
 	case 5: //cos(x)sin(x) - sin(x)
-		finalY = (cos(timePlot) * sin(timePlot)) - sin(timePlot);
-		finalX = (-sin(timePlot) * sin(timePlot)) + (cos(timePlot) * cos(timePlot)) - cos(timePlot);
+		y = (cos(t) * sin(t)) - sin(t);
+		x = (-sin(t) * sin(t)) + (cos(t) * cos(t)) - cos(t);
 		break;
 	case 6: //"4sin(x) + 3sin(x) + 2sin(x) + sin()"
-		finalY = sin(4 * timePlot) + sin(3 * timePlot) + sin(2 * timePlot) + sin(timePlot);
-		finalX = 4 * cos(4 * timePlot) + 3 * cos(3 * timePlot) + 2 * cos(2 * timePlot) + cos(timePlot);
+		y = sin(4 * t) + sin(3 * t) + sin(2 * t) + sin(t);
+		x = 4 * cos(4 * t) + 3 * cos(3 * t) + 2 * cos(2 * t) + cos(t);
 		break;
 	case 7: //"cos(4x) + cos(3x) + cos(2x) + cos()",
-		finalY = cos(4 * timePlot) + cos(3 * timePlot) + cos(2 * timePlot) + cos(timePlot);
-		finalX = -4 * sin(4 * timePlot) - 3 * sin(3 * timePlot) - 2 * sin(2 * timePlot) - sin(timePlot);
+		y = cos(4 * t) + cos(3 * t) + cos(2 * t) + cos(t);
+		x = -4 * sin(4 * t) - 3 * sin(3 * t) - 2 * sin(2 * t) - sin(t);
 		break;
 	case 8: // sin(7x) + sin(5x) + sin(3x) + sin(2x) + sin()
-		finalY = sin(7 * timePlot) + sin(5 * timePlot) + sin(3 * timePlot) + sin(2 * timePlot) + sin(timePlot);
-		finalX = 7 * cos(7 * timePlot) + 5 * cos(5 * timePlot) + 3 * cos(3 * timePlot) * 2 * cos(2 * timePlot) + cos(timePlot);
+		y = sin(7 * t) + sin(5 * t) + sin(3 * t) + sin(2 * t) + sin(t);
+		x = 7 * cos(7 * t) + 5 * cos(5 * t) + 3 * cos(3 * t) * 2 * cos(2 * t) + cos(t);
 		break;
 	case 9: // "sin(42x) + sin(13x) + sin(7x) + sin(3x) + sin()",
-		finalY = sin(42 * timePlot) + sin(13 * timePlot) + sin(7 * timePlot) + sin(3 * timePlot) + sin(timePlot);
-		finalX = 42 * cos(42 * timePlot) + 13 * cos(13 * timePlot) + 5 * cos(5 * timePlot) * 3 * cos(3 * timePlot) + cos(timePlot);
+		y = sin(42 * t) + sin(13 * t) + sin(7 * t) + sin(3 * t) + sin(t);
+		x = 42 * cos(42 * t) + 13 * cos(13 * t) + 5 * cos(5 * t) * 3 * cos(3 * t) + cos(t);
 		break;
 	}
 
-	if (!paused) {
-		timePlot += static_cast<float>(PI / plotTimeChangeRate); //ImGui::GetIO().DeltaTime;
+	return ImVec2(static_cast<float>(x), static_cast<float>(y));
+}
+
+void fourier::DrawPlotsTransformScrolling(bool& open) {
+	ImGui::Begin("DigitalPlots", &open);
+
+	static bool paused = false;
+	static bool showAnalog[2] = { true, true };
+	static bool flipSign = false;
+	static float prevX = 1.0f;
+
+	char label[32];
+	ImGui::Checkbox("cos(x)", &showAnalog[0]);  ImGui::SameLine();
+	ImGui::Checkbox("sin(x)", &showAnalog[1]); ImGui::SameLine();
+	ImGui::Checkbox("sample on worker", &isCurveWorker);
+
+	// on the worker the time advances as fast as with one sample per frame at 60 fps, the plots get the samples in between
+	const float step = static_cast<float>(PI / plotTimeChangeRate);
+	if (isCurveWorker && !paused)
+	{
+		if (!curveWorker.IsRunning())
+			curveWorker.Start(curve_current, step * 60.0f / CURVE_SAMPLE_RATE, timePlot);
+		curveWorker.Set(curve_current, step * 60.0f / CURVE_SAMPLE_RATE);
+		// the hidden curves are recorded as well, the worker does not wait for the ui
+		for (int i = 0; i < 2; i++)
+			curveWorker.samples[i].Drain(dataAnalog[i]);
+		if (dataAnalog[1].Data.Size > 0)
+			timePlot = -dataAnalog[1].Newest().x;
+	}
+	else
+	{
+		curveWorker.Stop();
+	}
+
+	const ImVec2 value = EvaluateCurve(curve_current, timePlot);
+	finalX = value.x;
+	finalY = value.y;
+
+	if (!paused && !isCurveWorker) {
+		timePlot += step; //ImGui::GetIO().DeltaTime;
 		if (showAnalog[0])
 			dataAnalog[0].AddPoint(-timePlot, finalX);
 		if (showAnalog[1])
@@ -983,7 +1435,7 @@ void fourier::DrawPlotsTransformScrolling(bool& open) {
 			if (showAnalog[i]) {
 				strcpy_s(label, 32, i ? "sin(x)" : "cos(x)");
 				if (dataAnalog[i].Data.size() > 0)
-					ImPlot::PlotLine(label, &dataAnalog[i].Data[0].x, &dataAnalog[i].Data[0].y, dataAnalog[i].Data.size(), dataAnalog[i].Offset, 2 * sizeof(float));
+					PlotScrolling(label, dataAnalog[i]);
 			}
 		}
 		ImPlot::EndPlot();
@@ -1022,7 +1474,7 @@ void fourier::DrawPlots(bool& p_open) {
 			if (showAnalog[i]) {
 				strcpy_s(label, 32, i ? "im" : "re");
 				if (dataAnalog[i].Data.size() > 0)
-					ImPlot::PlotLine(label, &dataAnalog[i].Data[0].x, &dataAnalog[i].Data[0].y, dataAnalog[i].Data.size(), dataAnalog[i].Offset, 2 * sizeof(float));
+					PlotScrolling(label, dataAnalog[i]);
 			}
 		}
 		ImPlot::EndPlot();
@@ -1035,219 +1487,83 @@ void fourier::SetupSingleWavelet()
 	waveletGenerator.AddWavelet(1, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
 }
 
+// the integer strategies as one synthesized series of numHarmonics wavelets,
+// only the wavelets of at least half a pixel are added to be drawn
+void fourier::SetupSynthesizedWavelets()
+{
+	const int first = strategy_current == 2 ? 2 : 1;
+	const int step = strategy_current == 0 ? 1 : 2;
+
+	int visible = 0;
+	while (visible < numHarmonics && visible < MAX_SERIES_NODES && abs(waveletGenerator.GetRadius(first + step * visible)) >= 0.5f)
+	{
+		waveletGenerator.AddWavelet(first + step * visible, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
+		visible++;
+	}
+	waveletGenerator.Synthesize(first, step, numHarmonics, static_cast<int>(lround(timeChangeRate)));
+}
+
+// the wavelets of the series follow the node count in place: the missing ones are appended, the surplus ones dropped.
+// the fixed sets (custom, square) and the synthesized series do not depend on it
+void fourier::ResizeWavelets()
+{
+	if (concept_current != 0 || (isSynthesisMode && strategy_current <= 2) || strategy_current >= 10)
+		return;
+
+	if (waveletGenerator.GetSize() > numNodes)
+		waveletGenerator.Truncate(numNodes);
+	else
+		SetupMulitpleWavelets();
+}
+
+// adds the wavelets of the strategy from the current size on, ie. all of them after a clear
 void fourier::SetupMulitpleWavelets()
 {
-	int fiba = 1;
-	int nacho = 1;
+	if (isSynthesisMode && strategy_current <= 2)
+	{
+		SetupSynthesizedWavelets();
+		return;
+	}
 
+	const int first = waveletGenerator.GetSize();
+	waveletGenerator.Reserve(numNodes);
 	switch (strategy_current)
 	{
 	case 0:
 		// uneven
-		for (int i = 0; i < numNodes; i++)
+		for (int i = first; i < numNodes; i++)
 		{
 			waveletGenerator.AddWavelet((i + 1), IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255)); // add uneven indecies
 		}
 		break;
 	case 1:
 		// uneven
-		for (int i = 0; i < numNodes; i++)
+		for (int i = first; i < numNodes; i++)
 		{
 			waveletGenerator.AddWavelet(((i + 1) * 2) - 1, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255)); // add uneven indecies
 		}
 		break;
 	case 2:
 		//even
-		for (int i = 0; i < numNodes; i++)
+		for (int i = first; i < numNodes; i++)
 		{
 			waveletGenerator.AddWavelet(((i + 1) * 2), IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255)); // add even indecies
 		}
 		break;
-	case 3:
-		//fibonacci
-		for (int i = 0; i < numNodes; i++)
-		{
-			waveletGenerator.AddWavelet(nacho, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255)); // add all indecies
-			nacho += fiba;
-			fiba = nacho;
-		}
-		break;
-	case 4:
-		// primary numbers
-		waveletGenerator.AddWavelet(2, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(3, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(5, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(7, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(11, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(13, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(17, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(19, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(23, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(29, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(31, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(37, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(41, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(43, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(47, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(53, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(59, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(61, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(67, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(71, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(73, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(79, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(83, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(89, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(97, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(101, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(103, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(107, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(109, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(113, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(127, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(131, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(137, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(139, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(149, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(151, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(157, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(163, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(167, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(173, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(179, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(181, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(191, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(193, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(197, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(199, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(211, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(223, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(227, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(229, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		break;
-	case 5:
-		// "uneven" primary numbers
-		waveletGenerator.AddWavelet(3, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(7, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(13, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(19, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(29, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(37, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(43, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(53, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(61, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(71, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(79, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(89, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(101, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(107, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(113, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(131, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(139, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(151, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(163, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(173, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(181, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(193, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(199, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(223, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		break;
-	case 6:
-		// "even" primary numbers
-		waveletGenerator.AddWavelet(2, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(5, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(11, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(17, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(23, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(31, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(41, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(47, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(59, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(67, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(73, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(83, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(97, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(103, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(109, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(127, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(137, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(149, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(157, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(167, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(179, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(191, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(197, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(211, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		break;
-	case 7:
-		// "ballanced" primary numbers
-		waveletGenerator.AddWavelet(5, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(53, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(157, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(173, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(211, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(257, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(263, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(373, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(563, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		break;
-	case 8:
-		// "emirps" primary numbers
-		waveletGenerator.AddWavelet(13, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(17, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(31, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(37, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(71, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(73, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(79, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(97, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(107, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(113, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(149, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(157, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(167, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(179, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(199, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		break;
-	case 9:
-		// "euler irregular" primary numbers
-		waveletGenerator.AddWavelet(19, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(31, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(43, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(47, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(61, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(67, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(71, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(79, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(101, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(137, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(139, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(149, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(193, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(223, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(241, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(251, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(263, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(277, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(307, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(311, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(349, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(353, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(359, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(373, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(379, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(419, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(433, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(461, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(463, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(491, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(509, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(541, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(563, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(571, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(577, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
-		waveletGenerator.AddWavelet(587, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
+	case 3: // fibonacci
+	case 4: // primary numbers
+	case 5: // "uneven" primary numbers
+	case 6: // "even" primary numbers
+	case 7: // "ballanced" primary numbers
+	case 8: // "emirps" primary numbers
+	case 9: // "euler irregular" primary numbers
+	{
+		const Sequences::Kind kind = StrategySequence(strategy_current);
+		const int count = numNodes < Sequences::GetLength(kind) ? numNodes : Sequences::GetLength(kind);
+		if (count > first)
+			waveletGenerator.AddWavelets(Sequences::Get(kind) + first, count - first, IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
 		break;
+	}
 	case 10: // custom use result buffer if it contains data
 		if (result.Data.size() > 0)
 		{
@@ -1283,9 +1599,24 @@ void fourier::SetupMulitpleWavelets()
 	}
 }
 
-void fourier::Clear()
+// only the samples that shape the trace are kept, see PolylineSimplifier
+void fourier::AddTracePoint(ImVec2 p)
+{
+	ImVec2 kept;
+	if (traceSimplifier.Add(p, kept))
+		tracer.AddPoint(kept.x, kept.y);
+}
+
+void fourier::EraseTrace()
 {
 	tracer.Erase();
+	traceSimplifier.Reset();
+}
+
+void fourier::Clear()
+{
+	curveWorker.Stop(); // restarts from the new time plot, its clock would carry on with the old one
+	EraseTrace();
 	dataModulated.Erase();
 	dataAnalog[0].Erase();
 	dataAnalog[1].Erase();
@@ -1294,6 +1625,81 @@ void fourier::Clear()
 	finalX = 0.0f;
 }
 
+// one period of the path drawn by the epicycles of the given coefficients, sample j belongs to time 2*pi*j/n
+// the coefficients are normalized already, so the not normalized inverse transform is the sum of the epicycles
+static void SynthesizePath(const std::vector<WaveletStruct>& dft, size_t n, std::vector<Complex>& path)
+{
+	path.assign(n, Complex(0.0, 0.0));
+	for (const WaveletStruct& wavelet : dft)
+	{
+		const size_t k = static_cast<size_t>(wavelet.frequency) % n;
+		path[k].add(Complex(wavelet.re, wavelet.im));
+	}
+	FFT::Inverse(path);
+}
+
+// energy of the coefficients except the offset (dc), by parseval this is the mean square of the path around its center
+static double GetAcEnergy(const std::vector<WaveletStruct>& dft)
+{
+	double energy = 0.0;
+	for (const WaveletStruct& wavelet : dft)
+		if (wavelet.frequency != 0.0)
+			energy += wavelet.amplitude * wavelet.amplitude;
+	return energy;
+}
+
+// keeps the coefficients picked by the selection, sorted by amplitude. at most MAX_NODES of them are kept, the epicycles
+// are evaluated every frame
+// - all / largest: the MAX_NODES / count coefficients of the largest amplitude, the partial selection is O(N),
+//   only the kept ones are sorted
+// - energy fraction / rms error: the fewest coefficients whose dropped energy stays within allowed,
+//   ie. the smallest ones are dropped until the next one would exceed it. the offset (dc) is always kept.
+//   capped is set if that takes more than MAX_NODES, the bound is not met then
+// returns the energy of the dropped coefficients, which by parseval is the mean square reconstruction error
+static double SelectCoefficients(std::vector<WaveletStruct>& dft, int selection, size_t count, double allowed, bool& capped)
+{
+	double dropped = 0.0;
+	capped = false;
+	if (selection < 2)
+	{
+		const size_t keep = IM_MIN(dft.size(), selection == 1 ? IM_MIN(count, static_cast<size_t>(MAX_NODES)) : static_cast<size_t>(MAX_NODES));
+		if (keep < dft.size())
+		{
+			std::nth_element(dft.begin(), dft.begin() + keep, dft.end(), greater_than_key());
+			for (size_t i = keep; i < dft.size(); i++)
+				dropped += dft[i].amplitude * dft[i].amplitude;
+			dft.resize(keep);
+		}
+		std::sort(dft.begin(), dft.end(), greater_than_key());
+		return dropped;
+	}
+
+	std::sort(dft.begin(), dft.end(), greater_than_key());
+	auto dc = std::find_if(dft.begin(), dft.end(), [](const WaveletStruct& wavelet) { return wavelet.frequency == 0.0; });
+	if (dc != dft.end())
+		std::rotate(dft.begin(), dc, dc + 1);
+
+	size_t keep = dft.size();
+	while (keep > 1)
+	{
+		const double energy = dft[keep - 1].amplitude * dft[keep - 1].amplitude;
+		if (dropped + energy > allowed)
+			break;
+		dropped += energy;
+		keep--;
+	}
+	if (keep > MAX_NODES)
+	{
+		capped = true;
+		for (size_t i = MAX_NODES; i < keep; i++)
+			dropped += dft[i].amplitude * dft[i].amplitude;
+		keep = MAX_NODES;
+	}
+	dft.resize(keep);
+
+	return dropped;
+}
+
 void fourier::Setup()
 {
 	if (concept_current == 0) // fourier series
@@ -1301,6 +1707,18 @@ void fourier::Setup()
 	else // demodulation and fourier transform
 		SetupSingleWavelet();
 
+	RequestSpectrum();
+}
+
+// the transforms only depend on the captured path: while its revision is the same, the complete spectra
+// are taken over from the last published spectrum and only the selection of the coefficients is redone
+void fourier::RequestSpectrum()
+{
+	std::shared_ptr<const Spectrum> last = spectrumWorker.Get();
+	std::shared_ptr<const SpectrumSource> source;
+	if (last && last->source && last->source->revision == result.Revision)
+		source = last->source;
+
 	// testing
 	std::vector<float> xdata = {};
 	std::vector<float> ydata = {};
@@ -1308,7 +1726,7 @@ void fourier::Setup()
 	std::vector<Complex> data = {};
 
 
-	if (result.Data.size() > 0)
+	if (!source && result.Data.size() > 0)
 	{
 		for (int i = 1; i < result.Data.size(); i++)
 		{
@@ -1317,7 +1735,7 @@ void fourier::Setup()
 			data.push_back(Complex(result.Data[i].x, result.Data[i].y));
 		}
 	}
-	else
+	else if (!source)
 	{
 		// a square ???
 		for (int i = 0; i <= 100; i++)
@@ -1349,29 +1767,215 @@ void fourier::Setup()
 	// get the discrete fourier components
 	int s = static_cast<int>(xdata.size());
 
+	// every captured point goes into the transform, the fft handles any number of samples
+	// the spectra are computed by the worker, the path is copied into the job so capturing can go on meanwhile
+	// the complex spectrum and the x/y spectra are independent, large transforms split further across the cores
+	// the epicycles are drawn from the selected coefficients only, the error of the selection is reported in Properties
+	// the error budget of the rms mode is split evenly between the x and y spectra, the fraction applies to each of them
+	const unsigned int revision = result.Revision;
+	const int selection = selection_current;
+	const size_t count = static_cast<size_t>(numNodes);
+	const double fraction = static_cast<double>(energyFraction);
+	const double rms = static_cast<double>(rmsError);
+	spectrumWorker.Request([this, source, xdata, ydata, data, s, revision, selection, count, fraction, rms](Spectrum& spectrum)
+	{
+		if (source)
+			spectrum.source = source;
+		else
+		{
+			std::shared_ptr<SpectrumSource> transformed = std::make_shared<SpectrumSource>();
+			transformed->numSamples = static_cast<size_t>(s);
+			transformed->revision = revision;
+			Parallel::Invoke({
+				[&] { transformed->Cdft = DFT(data, s); },
+				[&] { DFT(xdata, ydata, s, transformed->Xdft, transformed->Ydft); },
+			});
+			spectrum.source = transformed;
+		}
+		if (spectrumWorker.IsSuperseded(spectrum.generation))
+			return;
+
+		spectrum.numSamples = spectrum.source->numSamples;
+		Parallel::Invoke({
+			[&] {
+				spectrum.Cdft = spectrum.source->Cdft;
+				const double energy = GetAcEnergy(spectrum.Cdft);
+				const double dropped = SelectCoefficients(spectrum.Cdft, selection, count, selection == 2 ? (1.0 - fraction) * energy : rms * rms, spectrum.cappedC);
+				spectrum.rmsErrorC = sqrt(dropped);
+				spectrum.energyKeptC = energy > 0.0 ? 1.0 - dropped / energy : 1.0;
+
+				std::vector<Complex> path;
+				SynthesizePath(spectrum.Cdft, spectrum.numSamples, path);
+				spectrum.pathC.resize(path.size());
+				for (size_t i = 0; i < path.size(); i++)
+					spectrum.pathC[i] = ImVec2(static_cast<float>(path[i].re), static_cast<float>(path[i].im));
+			},
+			[&] {
+				spectrum.Xdft = spectrum.source->Xdft;
+				spectrum.Ydft = spectrum.source->Ydft;
+				const double energyX = GetAcEnergy(spectrum.Xdft);
+				const double energyY = GetAcEnergy(spectrum.Ydft);
+				double droppedX = 0.0;
+				double droppedY = 0.0;
+				bool cappedX = false;
+				bool cappedY = false;
+				Parallel::Invoke({
+					[&] { droppedX = SelectCoefficients(spectrum.Xdft, selection, count, selection == 2 ? (1.0 - fraction) * energyX : 0.5 * rms * rms, cappedX); },
+					[&] { droppedY = SelectCoefficients(spectrum.Ydft, selection, count, selection == 2 ? (1.0 - fraction) * energyY : 0.5 * rms * rms, cappedY); },
+				});
+				spectrum.cappedXY = cappedX || cappedY;
+				spectrum.rmsErrorXY = sqrt(droppedX + droppedY);
+				spectrum.energyKeptXY = energyX + energyY > 0.0 ? 1.0 - (droppedX + droppedY) / (energyX + energyY) : 1.0;
+
+				// the y epicycles are drawn rotated by pi/2, so both axes are the real part of their path
+				std::vector<Complex> pathX;
+				std::vector<Complex> pathY;
+				Parallel::Invoke({
+					[&] { SynthesizePath(spectrum.Xdft, spectrum.numSamples, pathX); },
+					[&] { SynthesizePath(spectrum.Ydft, spectrum.numSamples, pathY); },
+				});
+				spectrum.pathXY.resize(pathX.size());
+				for (size_t i = 0; i < pathX.size(); i++)
+					spectrum.pathXY[i] = ImVec2(static_cast<float>(pathX[i].re), static_cast<float>(pathY[i].re));
+			},
+		});
+	});
+}
+
+SpectrumWorker::SpectrumWorker()
+{
+	this->jobGeneration = 0;
+	this->requested = 0;
+	this->published = 0;
+	this->quit = false;
+
+	// the thread pool used by the jobs has to outlive the worker
+	Parallel::GetThreadCount();
+	this->thread = std::thread(&SpectrumWorker::Work, this);
+}
 
-	// need to restrict max number of frequencies or image gets whacked
-	int maxlen = 1000;
-	std::vector<Complex> tmp;
-	std::vector<float> tmpx;
-	std::vector<float> tmpy;
-	int step = (s / maxlen) + 1;
-	for (int i = 0; i < s; i += step)
+SpectrumWorker::~SpectrumWorker()
+{
 	{
-		if (i < data.size())
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+		requested++; // cancels the running job
+	}
+	wakeup.notify_one();
+	thread.join();
+}
+
+void SpectrumWorker::Request(std::function<void(Spectrum&)> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->job = std::move(job);
+		jobGeneration = ++requested;
+	}
+	wakeup.notify_one();
+}
+
+bool SpectrumWorker::IsSuperseded(unsigned int generation) const
+{
+	return generation != requested.load();
+}
+
+bool SpectrumWorker::IsBusy() const
+{
+	return published.load() != requested.load();
+}
+
+std::shared_ptr<const Spectrum> SpectrumWorker::Get() const
+{
+	return std::atomic_load(&current);
+}
+
+void SpectrumWorker::Work()
+{
+	for (;;)
+	{
+		std::function<void(Spectrum&)> next;
+		std::shared_ptr<Spectrum> spectrum = std::make_shared<Spectrum>();
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeup.wait(lock, [this] { return quit || job; });
+			if (quit)
+				return;
+			next = std::move(job);
+			job = nullptr;
+			spectrum->generation = jobGeneration;
+		}
+
+		next(*spectrum);
+
+		// a newer request may have come in meanwhile, its result is the one to show
+		if (!IsSuperseded(spectrum->generation))
 		{
-			tmp.push_back(data[i]);
-			tmpx.push_back(data[i].re);
-			tmpy.push_back(data[i].im);
+			std::atomic_store(&current, std::shared_ptr<const Spectrum>(spectrum));
+			published = spectrum->generation;
 		}
 	}
-	Cdft = DFT(tmp, tmp.size());
-	Xdft = DFT(tmpx, tmpx.size());
-	Ydft = DFT(tmpy, tmpy.size());
+}
 
-	std::sort(Xdft.begin(), Xdft.end(), greater_than_key());
-	std::sort(Ydft.begin(), Ydft.end(), greater_than_key());
-	std::sort(Cdft.begin(), Cdft.end(), greater_than_key());
+CurveWorker::CurveWorker()
+{
+	this->running = false;
+	this->curve = 0;
+	this->step = 0.0f;
+	this->time = 0.0;
+}
+
+CurveWorker::~CurveWorker()
+{
+	Stop();
+}
+
+void CurveWorker::Start(int curve, float step, double time)
+{
+	Stop();
+	this->curve = curve;
+	this->step = step;
+	this->time = time;
+	running = true;
+	thread = std::thread(&CurveWorker::Work, this);
+}
+
+// the samples not drained yet are dropped, they belong to the clock of the stopped thread
+void CurveWorker::Stop()
+{
+	running = false;
+	if (thread.joinable())
+		thread.join();
+	samples[0].Discard();
+	samples[1].Discard();
+}
+
+void CurveWorker::Set(int curve, float step)
+{
+	this->curve = curve;
+	this->step = step;
+}
+
+bool CurveWorker::IsRunning() const
+{
+	return running.load();
+}
+
+void CurveWorker::Work()
+{
+	const std::chrono::nanoseconds period(1000000000 / CURVE_SAMPLE_RATE);
+	std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+	while (running.load())
+	{
+		for (const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now(); next <= now; next += period)
+		{
+			time += step.load();
+			const ImVec2 value = EvaluateCurve(curve.load(), time);
+			samples[0].AddPoint(static_cast<float>(-time), value.x);
+			samples[1].AddPoint(static_cast<float>(-time), value.y);
+		}
+		std::this_thread::sleep_until(next);
+	}
 }
 
 WaveletGenerator::WaveletGenerator(float radius)
@@ -1383,6 +1987,13 @@ WaveletGenerator::WaveletGenerator(float radius)
 	this->range = 0.0f;
 	this->maxRange = MAX_FREQUENCY * TWO_PI;
 	this->pauseDemodulator = false;
+	this->useRotors = false;
+	this->rotorsSynced = false;
+	this->rotorTime = 0.0f;
+	this->rotorStep = 0.0f;
+	this->rotorSteps = 0;
+	this->sincosTier = SinCos::Fast;
+	this->culled = 0;
 }
 
 WaveletGenerator::~WaveletGenerator()
@@ -1390,28 +2001,33 @@ WaveletGenerator::~WaveletGenerator()
 	Clear();
 }
 
+// the arrays keep their capacity, so the next setup does not allocate again
 void WaveletGenerator::Clear()
 {
-	for (int i = 0; i < waveletQueue.size(); i++)
-	{
-		if (waveletQueue[i])
-			delete(waveletQueue[i]);
-	}
-	waveletQueue.clear();
+	indices.clear();
+	radii.clear();
+	signs.clear();
+	rotations.clear();
+	tips.clear();
+	phasors.clear();
+	rotors.clear();
+	attributes.clear();
+	synthesis.clear();
 	normalizer = 0;
 	range = 0.0f;
 	maxRange = MAX_FREQUENCY * TWO_PI;
 	pauseDemodulator = false;
+	rotorsSynced = false;
 }
 
-void WaveletGenerator::Rotate(bool isClockwise, int i, float t)
+void WaveletGenerator::Rotate(int i, float t)
 
 {
 	//float pi = acosf(-1);
 	//float re = 0.0f;
 	//float im = 0.0f;
 
-	//_Fcomplex dt = { 0.0F, t * waveletQueue[i]->index };
+	//_Fcomplex dt = { 0.0F, t * indices[i] };
 	//_Fcomplex rot = cexpf(dt);
 	//float phase = atan2(cimagf(dt), crealf(dt)); //?
 
@@ -1430,19 +2046,21 @@ void WaveletGenerator::Rotate(bool isClockwise, int i, float t)
 	//float check4 = sqrt(crealf(ce4) * crealf(ce4) + cimagf(ce4) * cimagf(ce4));// -1.0f;
 	//float check5 = sqrt(crealf(ce5) * crealf(ce5) + cimagf(ce5) * cimagf(ce5));// -1.0f;
 
-	waveletQueue[i]->rotation = ImVec2(waveletQueue[i]->radius * cos(t * waveletQueue[i]->index), waveletQueue[i]->radius * sin(t * waveletQueue[i]->index));
-
-	if (!isClockwise)
-	{
-		waveletQueue[i]->rotation.y *= -1;
-	}
+	rotations[i] = ImVec2(radii[i] * cos(t * indices[i]), radii[i] * sin(t * indices[i]) * signs[i]);
+	Place(i);
+}
 
-	if (i > 0)
-		waveletQueue[i]->tail = ImVec2(waveletQueue[i - 1]->tip.x, waveletQueue[i - 1]->tip.y);
-	else
-		waveletQueue[0]->tail = ImVec2(0.0f, 0.0f);
+// chains the rotated wavelet to the tip of the previous one
+void WaveletGenerator::Place(int i)
+{
+	const ImVec2 tail = GetTail(i);
+	tips[i] = ImVec2(tail.x + rotations[i].x, tail.y + rotations[i].y);
+}
 
-	waveletQueue[i]->tip = ImVec2(waveletQueue[i]->tail.x + waveletQueue[i]->rotation.x, waveletQueue[i]->tail.y + waveletQueue[i]->rotation.y);
+// the tail of a wavelet is the tip of the previous one, the first one starts at the origin
+ImVec2 WaveletGenerator::GetTail(int i)
+{
+	return i > 0 ? tips[i - 1] : ImVec2(0.0f, 0.0f);
 }
 
 // will draw a full data set wound arround the wavelet numOfTimes times
@@ -1464,9 +2082,10 @@ void WaveletGenerator::DrawWavelet(ExampleAppLog& log,
 
 	this->maxRange = numOfTimes + 1.0f;
 
-	waveletQueue[index]->numCoords = 0;
-	waveletQueue[index]->totX = 0.0f;
-	waveletQueue[index]->totY = 0.0f;
+	WaveletAttributes& attribute = attributes[index];
+	attribute.numCoords = 0;
+	attribute.totX = 0.0f;
+	attribute.totY = 0.0f;
 
 	float rotation = 0.0f;
 	float rotationStep = (TWO_PI * this->range) / curve.Data.size();
@@ -1476,27 +2095,27 @@ void WaveletGenerator::DrawWavelet(ExampleAppLog& log,
 	{
 		factor = curve.Data[i].y; // here is a tricky problem
 		rotation += rotationStep;
-		Rotate(waveletQueue[index]->isClockwise, index, -rotation);
+		Rotate(index, -rotation);
 
-		ImVec2 center = ImVec2(waveletQueue[index]->tail.x + origin.x, waveletQueue[index]->tail.y + origin.y);
-		ImVec2 tail = ImVec2(waveletQueue[index]->tip.x + origin.x, waveletQueue[index]->tip.y + origin.y);
-		ImVec2 tip = ImVec2((waveletQueue[index]->tip.x * factor) + origin.x + waveletQueue[index]->tip.x, (waveletQueue[index]->tip.y * factor) + origin.y + waveletQueue[index]->tip.y);
+		const ImVec2 wtip = tips[index];
+		ImVec2 tail = ImVec2(wtip.x + origin.x, wtip.y + origin.y);
+		ImVec2 tip = ImVec2((wtip.x * factor) + origin.x + wtip.x, (wtip.y * factor) + origin.y + wtip.y);
 
-		waveletQueue[index]->totX += waveletQueue[index]->tip.x * factor;
-		waveletQueue[index]->totY += waveletQueue[index]->tip.y * factor;
-		waveletQueue[index]->numCoords++;
+		attribute.totX += wtip.x * factor;
+		attribute.totY += wtip.y * factor;
+		attribute.numCoords++;
 
-		waveletQueue[index]->pog = ImVec2(waveletQueue[index]->totX / static_cast<float>(waveletQueue[index]->numCoords),
-			waveletQueue[index]->totY / static_cast<float>(waveletQueue[index]->numCoords));
+		attribute.pog = ImVec2(attribute.totX / static_cast<float>(attribute.numCoords),
+			attribute.totY / static_cast<float>(attribute.numCoords));
 
-		cog = ImVec2(waveletQueue[index]->pog.x, waveletQueue[index]->pog.y);
+		cog = ImVec2(attribute.pog.x, attribute.pog.y);
 		if (drawCircles)
 		{
 			draw_list->AddCircle(tip, 2.0f, IM_COL32(20, 125, 225, 255), 0, 2.0f);
 		}
 
 		if (drawEdges)
-			draw_list->AddLine(tail, tip, waveletQueue[index]->color, waveletQueue[index]->thikness);
+			draw_list->AddLine(tail, tip, attribute.color, attribute.thickness);
 	}
 
 	if (this->range >= this->maxRange)
@@ -1507,9 +2126,9 @@ void WaveletGenerator::DrawWavelet(ExampleAppLog& log,
 
 	// just use the real part of an imaginary number which happens to be the y axis here
 	// so the x axis represents the imaginary part, weired why it is not the other way arround
-	float sinX = 2.0f * cog.y / waveletQueue[index]->radius;
-	float cosX = 2.0f * cog.x / waveletQueue[index]->radius;
-	float magnitude = sqrt((4 * cog.x * cog.x) + (4 * cog.y * cog.y)) / waveletQueue[index]->radius;
+	float sinX = 2.0f * cog.y / radii[index];
+	float cosX = 2.0f * cog.x / radii[index];
+	float magnitude = sqrt((4 * cog.x * cog.x) + (4 * cog.y * cog.y)) / radii[index];
 
 	demodulator[0].AddPoint(this->range, cosX);
 	demodulator[1].AddPoint(this->range, -sinX);
@@ -1534,53 +2153,160 @@ void WaveletGenerator::DrawWavelet(ExampleAppLog& log,
 
 void WaveletGenerator::DrawWavelet(ImDrawList* draw_list, int index, float t, float factor, ImVec2 origin, bool drawCircles, bool drawEdges)
 {
-	Rotate(waveletQueue[index]->isClockwise, index, t);
-	ImVec2 center = ImVec2(waveletQueue[index]->tail.x + origin.x, waveletQueue[index]->tail.y + origin.y);
-	ImVec2 tail = ImVec2((waveletQueue[index]->tip.x + origin.x), (waveletQueue[index]->tip.y + origin.y));
-	ImVec2 tip = ImVec2(((waveletQueue[index]->tip.x * factor) + origin.x + waveletQueue[index]->tip.x), ((waveletQueue[index]->tip.y * factor) + origin.y + waveletQueue[index]->tip.y));
+	Rotate(index, t);
+	WaveletAttributes& attribute = attributes[index];
+	const ImVec2 wtail = GetTail(index);
+	const ImVec2 wtip = tips[index];
+	ImVec2 center = ImVec2(wtail.x + origin.x, wtail.y + origin.y);
+	ImVec2 tail = ImVec2((wtip.x + origin.x), (wtip.y + origin.y));
+	ImVec2 tip = ImVec2(((wtip.x * factor) + origin.x + wtip.x), ((wtip.y * factor) + origin.y + wtip.y));
 
-	waveletQueue[index]->totX += waveletQueue[index]->tip.x * factor;
-	waveletQueue[index]->totY += waveletQueue[index]->tip.y * factor;
-	waveletQueue[index]->numCoords++;
+	attribute.totX += wtip.x * factor;
+	attribute.totY += wtip.y * factor;
+	attribute.numCoords++;
 
-	waveletQueue[index]->pog = ImVec2((waveletQueue[index]->totX / waveletQueue[index]->numCoords),
-		(waveletQueue[index]->totY / static_cast<float>(waveletQueue[index]->numCoords)));
+	attribute.pog = ImVec2((attribute.totX / attribute.numCoords),
+		(attribute.totY / static_cast<float>(attribute.numCoords)));
 
-	waveletQueue[index]->tip = ImVec2((waveletQueue[index]->tip.x * factor + waveletQueue[index]->tip.x), (waveletQueue[index]->tip.y * factor + waveletQueue[index]->tip.y));
+	tips[index] = ImVec2((wtip.x * factor + wtip.x), (wtip.y * factor + wtip.y));
 
 	if (drawCircles)
 	{
-		draw_list->AddCircle(center, abs(waveletQueue[index]->radius), waveletQueue[index]->color, 0, waveletQueue[index]->thikness);
-		draw_list->AddCircle(tail, abs(waveletQueue[index]->radius), waveletQueue[index]->color, 0, waveletQueue[index]->thikness);
+		draw_list->AddCircle(center, abs(radii[index]), attribute.color, 0, attribute.thickness);
+		draw_list->AddCircle(tail, abs(radii[index]), attribute.color, 0, attribute.thickness);
 	}
 
 	if (drawEdges)
-		draw_list->AddLine(tail, tip, waveletQueue[index]->color, waveletQueue[index]->thikness);
+		draw_list->AddLine(tail, tip, attribute.color, attribute.thickness);
+}
+
+// rotor mode: t usually advances by the same step every frame, so every phasor e^(i * index * t) is advanced
+// by multiplying it with its rotor e^(i * index * dt) instead of calling cos and sin.
+// the step is learned from two consecutive times, any other step (reset, slider change, wrap arround)
+// recomputes the phasors directly. the magnitude is renormalized every few steps and the phase resynced
+// now and then, so the rounding errors of the products can not add up
+#define ROTOR_RENORM_STEPS 64
+#define ROTOR_RESYNC_STEPS 4096
+
+void WaveletGenerator::AdvanceRotors(float t)
+{
+	const float delta = t - rotorTime;
+	const bool sameStep = rotorsSynced && rotorStep > 0.0f && fabsf(delta - rotorStep) <= 1e-3f * rotorStep;
+
+	if (sameStep && rotorSteps < ROTOR_RESYNC_STEPS)
+	{
+		rotorSteps++;
+		const bool renormalize = rotorSteps % ROTOR_RENORM_STEPS == 0;
+		const int count = GetSize();
+		for (int i = 0; i < count; i++)
+		{
+			phasors[i] = phasors[i].mult(rotors[i]);
+			if (renormalize)
+			{
+				const double length = sqrt(phasors[i].re * phasors[i].re + phasors[i].im * phasors[i].im);
+				phasors[i] = Complex(phasors[i].re / length, phasors[i].im / length);
+			}
+		}
+	}
+	else
+	{
+		const bool learnStep = rotorsSynced && !sameStep && delta > 0.0f;
+		if (learnStep)
+			rotorStep = delta;
+		const int count = GetSize();
+		for (int i = 0; i < count; i++)
+		{
+			phasors[i] = Complex(cos(t * indices[i]), sin(t * indices[i]));
+			if (learnStep)
+				rotors[i] = Complex(cos(rotorStep * indices[i]), sin(rotorStep * indices[i]));
+		}
+		rotorSteps = 0;
+		rotorsSynced = true;
+	}
+
+	rotorTime = t;
 }
 
 void WaveletGenerator::DrawWavelet(ImDrawList* draw_list, int index, float t, ImVec2 origin, bool drawCircles, bool drawEdges)
 {
-	Rotate(waveletQueue[index]->isClockwise, index, t);
+	Rotate(index, t);
+	Draw(draw_list, index, origin, drawCircles, drawEdges);
+}
 
-	ImVec2 tail = ImVec2(waveletQueue[index]->tail.x + origin.x, waveletQueue[index]->tail.y + origin.y);
-	ImVec2 tip = ImVec2(waveletQueue[index]->tip.x + origin.x, waveletQueue[index]->tip.y + origin.y);
+void WaveletGenerator::Draw(ImDrawList* draw_list, int index, ImVec2 origin, bool drawCircles, bool drawEdges)
+{
+	const ImVec2 wtail = GetTail(index);
+	ImVec2 tail = ImVec2(wtail.x + origin.x, wtail.y + origin.y);
+	ImVec2 tip = ImVec2(tips[index].x + origin.x, tips[index].y + origin.y);
 	if (drawCircles)
-		draw_list->AddCircle(tail, abs(waveletQueue[index]->radius), waveletQueue[index]->color, 0, waveletQueue[index]->thikness);
+		draw_list->AddCircle(tail, abs(radii[index]), attributes[index].color, 0, attributes[index].thickness);
 	if (drawEdges)
-		draw_list->AddLine(tail, tip, waveletQueue[index]->color, waveletQueue[index]->thikness);
+		draw_list->AddLine(tail, tip, attributes[index].color, attributes[index].thickness);
 }
 
+// all wavelets at once: the rotations and their running sum (the tips) are evaluated in one batch,
+// only the drawing touches the attributes
 void WaveletGenerator::DrawWavelets(ImDrawList* draw_list, float t, ImVec2 origin, bool drawCircles, bool drawEdges)
 {
-	for (int i = 0; i < waveletQueue.size(); i++)
+	const int count = GetSize();
+	if (count > 0)
 	{
-		DrawWavelet(draw_list, i, t, origin, drawCircles, drawEdges);
+		if (useRotors)
+		{
+			AdvanceRotors(t);
+			for (int i = 0; i < count; i++)
+				rotations[i] = ImVec2(static_cast<float>(radii[i] * phasors[i].re), static_cast<float>(radii[i] * phasors[i].im) * signs[i]);
+			WaveletKernels::Accumulate(tips.data(), rotations.data(), count);
+		}
+		else
+		{
+			WaveletKernels::Evaluate(rotations.data(), tips.data(), indices.data(), radii.data(), signs.data(), t, count, sincosTier);
+		}
+
+		// every wavelet is part of the tips, only the ones of at least LOD_MIN_RADIUS are drawn.
+		// a run of smaller ones is one edge from the tail of its first to the tip of its last wavelet
+		culled = 0;
+		if (drawCircles || drawEdges)
+		{
+			int run = -1; // first wavelet of the current run of culled ones
+			for (int i = 0; i <= count; i++)
+			{
+				if (i < count && abs(radii[i]) < LOD_MIN_RADIUS)
+				{
+					if (run < 0)
+						run = i;
+					culled++;
+					continue;
+				}
+				if (run >= 0 && drawEdges)
+				{
+					const ImVec2 wtail = GetTail(run);
+					draw_list->AddLine(ImVec2(wtail.x + origin.x, wtail.y + origin.y), ImVec2(tips[i - 1].x + origin.x, tips[i - 1].y + origin.y), attributes[run].color, attributes[run].thickness);
+				}
+				run = -1;
+				if (i < count)
+					Draw(draw_list, i, origin, drawCircles, drawEdges);
+			}
+		}
+	}
+	finalTip = count > 0 ? tips[count - 1] : ImVec2(0.0f, 0.0f);
+
+	// the synthesized tip of the complete series, the wavelets that are too small to be drawn are one edge
+	if (!synthesis.empty())
+	{
+		const int period = static_cast<int>(synthesis.size());
+		const int j = static_cast<int>(lround(t * period / TWO_PI)) % period;
+		const ImVec2 tip = synthesis[j < 0 ? j + period : j];
+		if (drawEdges)
+			draw_list->AddLine(ImVec2(finalTip.x + origin.x, finalTip.y + origin.y), ImVec2(tip.x + origin.x, tip.y + origin.y), IM_COL32(250, 250, 220, 120), 1.0f);
+		finalTip = tip;
 	}
 }
 
 void WaveletGenerator::DrawTraceLine(ImDrawList* draw_list, ImVec2 origin, bool drawEdges, float length, ImU32 color, float thickness)
 {
-	finalTip = waveletQueue.size() > 0 ? waveletQueue[waveletQueue.size() - 1]->tip : ImVec2(0.0f, 0.0f);
+	if (synthesis.empty())
+		finalTip = tips.size() > 0 ? tips.back() : ImVec2(0.0f, 0.0f);
 	if (!drawEdges) return;
 	ImVec2 ftip = ImVec2(finalTip.x + origin.x, finalTip.y + origin.y);
 	draw_list->AddLine(ftip, ImVec2((ftip.x + length), (ftip.y)), color, thickness);
@@ -1593,7 +2319,12 @@ ImVec2 WaveletGenerator::GetFinalTip()
 
 int WaveletGenerator::GetSize()
 {
-	return (int)waveletQueue.size();
+	return (int)indices.size();
+}
+
+int WaveletGenerator::GetCulled()
+{
+	return culled;
 }
 
 float WaveletGenerator::GetNormalizer()
@@ -1601,65 +2332,144 @@ float WaveletGenerator::GetNormalizer()
 	return normalizer;
 }
 
+// rescales the radii, the synthesized tips and the normalizer in place. only for the wavelets that depend on the
+// radius through their radius alone, ie. not the custom strategy nor the selection of the synthesized series
 void WaveletGenerator::SetRadius(float radius)
 {
 	if (radius > 2.0f)
 	{
+		const float scale = radius / this->radius;
+		for (float& r : radii)
+			r *= scale;
+		for (ImVec2& tip : synthesis)
+			tip = ImVec2(tip.x * scale, tip.y * scale);
+		normalizer *= scale;
 		this->radius = radius;
 	}
 }
 
-void WaveletGenerator::AddWavelet(bool isClockwise, float frequency, float magnitude, ImU32 color, float thickness)
+// drops the wavelets from count on, the remaining ones keep their state (and their rotors)
+void WaveletGenerator::Truncate(int count)
 {
-	Wavelet* wavelet = new Wavelet();
-	wavelet->color = color;
-	wavelet->thikness = thickness;
-	wavelet->min = ImVec2(numeric_limits<float>::max(), numeric_limits<float>::max());
-	wavelet->max = ImVec2(0.0f, 0.0f);
-	wavelet->pog = ImVec2(0.0f, 0.0f);
-	wavelet->numCoords = 0;
-	wavelet->totX = 0;
-	wavelet->totY = 0;
+	if (count >= GetSize())
+		return;
 
-	wavelet->index = frequency;
-	wavelet->radius = magnitude;
-	wavelet->isClockwise = isClockwise;
-	normalizer += abs(wavelet->radius);
+	indices.resize(count);
+	radii.resize(count);
+	signs.resize(count);
+	rotations.resize(count);
+	tips.resize(count);
+	phasors.resize(count);
+	rotors.resize(count);
+	attributes.resize(count);
 
-	waveletQueue.push_back(wavelet);
+	normalizer = 0;
+	for (float r : radii)
+		normalizer += abs(r);
 }
 
+void WaveletGenerator::AddWavelet(bool isClockwise, float frequency, float magnitude, ImU32 color, float thickness)
+{
+	Append(frequency, magnitude, isClockwise, color, thickness);
+}
 
-void WaveletGenerator::AddWavelet(int index, ImU32 color, float thickness)
+
+// radius of the wavelet of the given index in the square (or triangle) wave series
+float WaveletGenerator::GetRadius(double index)
 {
-	Wavelet* wavelet = new Wavelet();
-	wavelet->index = static_cast<float>(index);
-	wavelet->color = color;
-	wavelet->thikness = thickness;
-	wavelet->min = ImVec2(numeric_limits<float>::max(), numeric_limits<float>::max());
-	wavelet->max = ImVec2(0.0f, 0.0f);
-	wavelet->pog = ImVec2(0.0f, 0.0f);
-	wavelet->numCoords = 0;
-	wavelet->totX = 0;
-	wavelet->totY = 0;
-
-	if (isinf(index * PI))
-		wavelet->radius = 1.0f;
+	const double k = index;
+	float radius;
+	if (isinf(k * PI))
+		radius = 1.0f;
 	else if (!this->useAlternateSeries)
 	{
-		wavelet->radius = static_cast<float>(this->radius * (4 / (index * PI))); // square wave
+		radius = static_cast<float>(this->radius * (4 / (k * PI))); // square wave
 	}
 	else
 	{
-		wavelet->radius = static_cast<float>(this->radius * (8 / (index * index * PI * PI)) * (index % 4 == 1 ? 1.0f : -1.0f)); // triangle wave
+		radius = static_cast<float>(this->radius * (8 / (k * k * PI * PI)) * (fmod(k, 4.0) == 1.0 ? 1.0f : -1.0f)); // triangle wave
+	}
+
+	if (isinf(radius))
+		radius = 1.5f;
+	return radius;
+}
+
+void WaveletGenerator::AddWavelet(int index, ImU32 color, float thickness)
+{
+	Append(static_cast<float>(index), GetRadius(index), true, color, thickness);
+}
+
+// bulk insert of a whole index sequence, the arrays grow once
+void WaveletGenerator::AddWavelets(const uint64_t* sequence, int count, ImU32 color, float thickness)
+{
+	Reserve(GetSize() + count);
+	for (int i = 0; i < count; i++)
+	{
+		const double index = static_cast<double>(sequence[i]);
+		Append(static_cast<float>(index), GetRadius(index), true, color, thickness);
 	}
+}
 
-	if (isinf(wavelet->radius))
-		wavelet->radius = 1.5f;
+void WaveletGenerator::Reserve(int count)
+{
+	indices.reserve(count);
+	radii.reserve(count);
+	signs.reserve(count);
+	rotations.reserve(count);
+	tips.reserve(count);
+	phasors.reserve(count);
+	rotors.reserve(count);
+	attributes.reserve(count);
+}
 
-	normalizer += abs(wavelet->radius);
+// the final tip of the series with the indices first + step * k (k < count) for every frame of a period,
+// the wavelet of index n turns n times per period, so at the times 2pi * j / period it only
+// contributes to the bin n mod period. all radii are folded into their bins and
+// one inverse transform of the period gives every tip, the cost per frame is a lookup.
+// the wavelets added before (usually the large ones) are drawn as usual
+void WaveletGenerator::Synthesize(int first, int step, int count, int period)
+{
+	if (period < 1)
+		period = 1;
 
-	waveletQueue.push_back(wavelet);
+	std::vector<Complex> bins(period, Complex(0.0, 0.0));
+	double total = 0.0;
+	for (int k = 0; k < count; k++)
+	{
+		const int index = first + step * k;
+		const float radius = GetRadius(index);
+		bins[index % period].re += radius;
+		total += abs(radius);
+	}
+	FFT::Inverse(bins);
+
+	synthesis.resize(period);
+	for (int j = 0; j < period; j++)
+		synthesis[j] = ImVec2(static_cast<float>(bins[j].re), static_cast<float>(bins[j].im));
+	normalizer = static_cast<float>(total);
+}
+
+void WaveletGenerator::Append(float index, float radius, bool isClockwise, ImU32 color, float thickness)
+{
+	indices.push_back(index);
+	radii.push_back(radius);
+	signs.push_back(isClockwise ? 1.0f : -1.0f);
+	rotations.push_back(ImVec2(0.0f, 0.0f));
+	tips.push_back(ImVec2(0.0f, 0.0f));
+	phasors.push_back(Complex(1.0, 0.0));
+	rotors.push_back(Complex(1.0, 0.0));
+
+	WaveletAttributes attribute;
+	attribute.color = color;
+	attribute.thickness = thickness;
+	attribute.min = ImVec2(numeric_limits<float>::max(), numeric_limits<float>::max());
+	attribute.max = ImVec2(0.0f, 0.0f);
+	attribute.pog = ImVec2(0.0f, 0.0f);
+	attributes.push_back(attribute);
+
+	normalizer += abs(radius);
+	rotorsSynced = false;
 }
 
 void WaveletGenerator::EnableAlternateSeries(bool enabled)
@@ -1667,10 +2477,21 @@ void WaveletGenerator::EnableAlternateSeries(bool enabled)
 	useAlternateSeries = enabled;
 }
 
+void WaveletGenerator::EnableRotors(bool enabled)
+{
+	useRotors = enabled;
+	rotorsSynced = false;
+}
+
+void WaveletGenerator::SetSinCosTier(SinCos::Tier tier)
+{
+	sincosTier = tier;
+}
+
 ImVec2 WaveletGenerator::GetPog()
 {
-	if (waveletQueue.size() > 0)
-		return waveletQueue[0]->pog;
+	if (attributes.size() > 0)
+		return attributes[0].pog;
 	else
 		return ImVec2(0.0f, 0.0f);
 }
@@ -1685,96 +2506,107 @@ bool WaveletGenerator::Pause()
 	return pauseDemodulator;
 }
 
-// discrete fourier transform converts a set of float values to a set of strucklets
-// the float values either contain all x axis or all y axis values of a given path to be drawn
-// eg. in this case the dft needs to be performed twice, once for the x axis values and once for the y axis values
-std::vector<WaveletStruct> fourier::DFT(const std::vector<float> curve, int max_freq)
+// converts the raw (not normalized) fft bins into the strucklets used to draw the epicycles
+// frequencies beyond the number of bins wrap arround, the same way the naive dft does
+// the frequencies are independent of each other, so large spectra are converted on all cores
+static std::vector<WaveletStruct> ToWavelets(const std::vector<Complex>& bins, int max_freq)
 {
 	std::vector<WaveletStruct> res;
-	const size_t N = curve.size();
+	const size_t N = bins.size();
+	if (N == 0 || max_freq <= 0)
+		return res;
 
-	// k represents each discrete frequency
-	for (int k = 0; k < max_freq; k++)
+	res.resize(max_freq);
+	Parallel::For(0, max_freq, 4096, [&](size_t first, size_t last)
 	{
-		WaveletStruct wavelet;
-		wavelet.re = 0.0f;
-		wavelet.im = 0.0f;
-		for (int n = 0; n < N; n++)
+		for (size_t k = first; k < last; k++)
 		{
-			float phi = (TWO_PI * k * n) / N;
-			wavelet.re += curve[n] * cos(phi);
-			wavelet.im -= curve[n] * sin(phi);
+			WaveletStruct& wavelet = res[k];
+			wavelet.re = bins[k % N].re / N;
+			wavelet.im = bins[k % N].im / N;
+			wavelet.frequency = static_cast<double>(k);
+			wavelet.amplitude = sqrt(wavelet.re * wavelet.re + wavelet.im * wavelet.im);
+			wavelet.phase = atan2(wavelet.im, wavelet.re);
 		}
-
-		wavelet.re = wavelet.re / N;
-		wavelet.im = wavelet.im / N;
-
-		wavelet.frequency = static_cast<float>(k);
-		wavelet.amplitude = sqrt(wavelet.re * wavelet.re + wavelet.im * wavelet.im);
-
-		wavelet.phase = atan2(wavelet.im, wavelet.re);
-
-		res.push_back(wavelet);
-	}
+	});
 
 	return res;
 }
 
-std::vector<WaveletStruct> fourier::DFT(const std::vector<Complex> curve, int max_freq)
+// discrete fourier transform converts a set of float values to a set of strucklets
+// the float values either contain all x axis or all y axis values of a given path to be drawn
+// eg. in this case the dft needs to be performed twice, once for the x axis values and once for the y axis values
+// the bins are computed with the fft in O(N log N) for any N
+std::vector<WaveletStruct> fourier::DFT(const std::vector<float> curve, int max_freq)
 {
-	std::vector<WaveletStruct> res;
-	const size_t N = curve.size();
-
-	for (int k = 0; k < max_freq; k++)
-	{
-		Complex sum(0.0f, 0.0f);
-
-		for (int n = 0; n < N; n++)
-		{
-			const double phi = (TWO_PI * k * n) / N;
-			const Complex c(cos(phi), -sin(phi));
-			Complex tmp = curve[n];
-			sum.add(tmp.mult(c));
-		}
-
-		sum.re = sum.re / N;
-		sum.im = sum.im / N;
-
-		WaveletStruct wavelet;
-		wavelet.re = sum.re;
-		wavelet.im = sum.im;
-		wavelet.frequency = static_cast<double>(k);
-		wavelet.amplitude = sqrt(wavelet.re * wavelet.re + wavelet.im * wavelet.im);
-
-		wavelet.phase = atan2(wavelet.im, wavelet.re);
+	std::vector<Complex> bins;
+	FFT::ForwardReal(curve, bins);
+	return ToWavelets(bins, max_freq);
+}
 
-		res.push_back(wavelet);
-	}
+// x axis and y axis values of a path transformed together, both real signals are packed into one complex fft
+void fourier::DFT(const std::vector<float>& xcurve, const std::vector<float>& ycurve, int max_freq, std::vector<WaveletStruct>& xres, std::vector<WaveletStruct>& yres)
+{
+	std::vector<Complex> xbins;
+	std::vector<Complex> ybins;
+	FFT::ForwardRealPair(xcurve, ycurve, xbins, ybins);
+	xres = ToWavelets(xbins, max_freq);
+	yres = ToWavelets(ybins, max_freq);
+}
 
-	return res;
+std::vector<WaveletStruct> fourier::DFT(const std::vector<Complex> curve, int max_freq)
+{
+	std::vector<Complex> bins = curve;
+	FFT::Forward(bins);
+	return ToWavelets(bins, max_freq);
 }
 
-ImVec2 fourier::DrawEpiCycles(float origin_x, float origin_y, double rotation, std::vector<WaveletStruct>& fourier, double time)
+ImVec2 fourier::DrawEpiCycles(float origin_x, float origin_y, double rotation, const std::vector<WaveletStruct>& fourier, double time)
 {
 	ImDrawList* draw_list = ImGui::GetWindowDrawList();
 	double x = origin_x;
 	double y = origin_y;
+	const SinCos::Tier tier = static_cast<SinCos::Tier>(sincos_current);
+
+	const ImU32 color = IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255);
 
 	radiusCircle = 1.0f;
 
+	// the epicycles below LOD_MIN_RADIUS still move the tip, a run of them is drawn as one edge
+	bool isRun = false;
+	ImVec2 run;
 	for (int i = 0; i < fourier.size(); i++)
 	{
 		double prevx = x;
 		double prevy = y;
 
-		x += radiusCircle * fourier[i].amplitude * cos((fourier[i].frequency * time) + fourier[i].phase + rotation);
-		y += radiusCircle * fourier[i].amplitude * sin((fourier[i].frequency * time) + fourier[i].phase + rotation);
+		double s, c;
+		SinCos::Get(tier, (fourier[i].frequency * time) + fourier[i].phase + rotation, s, c);
+		x += radiusCircle * fourier[i].amplitude * c;
+		y += radiusCircle * fourier[i].amplitude * s;
+
+		const ImVec2 prev = ImVec2(static_cast<float>(prevx), static_cast<float>(prevy));
+		if (fourier[i].amplitude * radiusCircle < LOD_MIN_RADIUS)
+		{
+			if (!isRun)
+				run = prev;
+			isRun = true;
+			culledEpicycles++;
+			continue;
+		}
+		if (isRun && showEdges)
+			draw_list->AddLine(run, prev, color);
+		isRun = false;
 
 		if (showCircles)
-			draw_list->AddCircle(ImVec2(static_cast<float>(prevx), static_cast<float>(prevy)), static_cast<float>(fourier[i].amplitude * radiusCircle), IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
+			draw_list->AddCircle(prev, static_cast<float>(fourier[i].amplitude * radiusCircle), color);
 		if (showEdges)
-			draw_list->AddLine(ImVec2(static_cast<float>(prevx), static_cast<float>(prevy)), ImVec2(static_cast<float>(x), static_cast<float>(y)), IM_COL32(circle_color.x * 255, circle_color.y * 255, circle_color.z * 255, 255));
+			draw_list->AddLine(prev, ImVec2(static_cast<float>(x), static_cast<float>(y)), color);
 	}
 
-	return ImVec2(static_cast<float>(x), static_cast<float>(y));
+	const ImVec2 tip = ImVec2(static_cast<float>(x), static_cast<float>(y));
+	if (isRun && showEdges)
+		draw_list->AddLine(run, tip, color);
+
+	return tip;
 }
\ No newline at end of file
@@ -0,0 +1,587 @@
+#include "fft.h"
+#include "fft_kernels.h"
+#include "parallel.h"
+#include <math.h>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+// TWO_PI in fourier.h only has float precision which is not enough for the twiddle factors of large transforms
+static const double FFT_TWO_PI = 2.0 * acos(-1.0);
+
+// transforms of at least this size are split across the thread pool, grain is the minimum work per task
+static const size_t FFT_PARALLEL_SIZE = 1 << 14;
+static const size_t FFT_PARALLEL_GRAIN = 1 << 12;
+
+// plan cache, most recently used plan first
+// the cache is guarded by a mutex, the plans are read only once built,
+// so transforms of any size (the same one too) can run on several threads at the same time
+static std::mutex planMutex;
+static std::list<std::pair<size_t, std::shared_ptr<FFTPlan>>> planList;
+static std::unordered_map<size_t, std::list<std::pair<size_t, std::shared_ptr<FFTPlan>>>::iterator> planIndex;
+static size_t planCacheLimit = 64 * 1024 * 1024;
+static size_t planCacheUsage = 0;
+
+size_t FFTPlan::GetMemoryUsage() const
+{
+	return sizeof(FFTPlan)
+		+ swaps.capacity() * sizeof(unsigned int)
+		+ factors.capacity() * sizeof(int)
+		+ (twiddles.capacity() + chirp.capacity() + chirpSpectrum.capacity()) * sizeof(Complex);
+}
+
+// scratch buffers are per thread and per use, a real transform may run a Bluestein transform
+// which runs power of two transforms, so each of them needs its own buffer.
+// they grow to the largest size used on the thread and are kept for the next transform
+enum ScratchSlot
+{
+	ScratchReal,
+	ScratchMixedRadix,
+	ScratchBluestein,
+	ScratchCount,
+};
+
+static Complex* GetScratch(ScratchSlot slot, size_t n)
+{
+	static thread_local std::vector<Complex> scratch[ScratchCount];
+	if (scratch[slot].size() < n)
+		scratch[slot].resize(n);
+	return scratch[slot].data();
+}
+
+bool FFT::IsPowerOfTwo(size_t n)
+{
+	return n > 0 && (n & (n - 1)) == 0;
+}
+
+size_t FFT::NextPowerOfTwo(size_t n)
+{
+	size_t p = 1;
+	while (p < n)
+		p <<= 1;
+	return p;
+}
+
+// splits n into the radices 4, 2, 3, 5 and 7
+// returns false if n has a larger prime factor, those sizes are handled by Bluestein's algorithm
+bool FFT::Factorize(size_t n, std::vector<int>& factors)
+{
+	static const int radices[] = { 4, 2, 3, 5, 7 };
+	factors.clear();
+	for (int r = 0; r < IM_ARRAYSIZE(radices); r++)
+	{
+		while (n % radices[r] == 0)
+		{
+			factors.push_back(radices[r]);
+			n /= radices[r];
+		}
+	}
+	return n == 1;
+}
+
+std::shared_ptr<FFTPlan> FFT::GetPlan(size_t n, bool real)
+{
+	const size_t key = (n << 1) | (real ? 1 : 0);
+	{
+		std::lock_guard<std::mutex> lock(planMutex);
+		auto it = planIndex.find(key);
+		if (it != planIndex.end())
+		{
+			planList.splice(planList.begin(), planList, it->second);
+			return it->second->second;
+		}
+	}
+
+	// built outside of the lock, plans of other sizes can be requested while building (Bluestein, Real)
+	std::shared_ptr<FFTPlan> plan = BuildPlan(n, real);
+
+	std::lock_guard<std::mutex> lock(planMutex);
+	auto it = planIndex.find(key);
+	if (it != planIndex.end())
+	{
+		// someone else was faster
+		planList.splice(planList.begin(), planList, it->second);
+		return it->second->second;
+	}
+
+	planList.emplace_front(key, plan);
+	planIndex[key] = planList.begin();
+	planCacheUsage += plan->GetMemoryUsage();
+
+	// never drop the plan that was just added, even if it is larger than the limit on its own
+	while (planCacheUsage > planCacheLimit && planList.size() > 1)
+	{
+		planCacheUsage -= planList.back().second->GetMemoryUsage();
+		planIndex.erase(planList.back().first);
+		planList.pop_back();
+	}
+
+	return plan;
+}
+
+void FFT::SetPlanCacheLimit(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(planMutex);
+	planCacheLimit = bytes;
+	while (planCacheUsage > planCacheLimit && planList.size() > 0)
+	{
+		planCacheUsage -= planList.back().second->GetMemoryUsage();
+		planIndex.erase(planList.back().first);
+		planList.pop_back();
+	}
+}
+
+size_t FFT::GetPlanCacheUsage()
+{
+	std::lock_guard<std::mutex> lock(planMutex);
+	return planCacheUsage;
+}
+
+void FFT::ClearPlanCache()
+{
+	std::lock_guard<std::mutex> lock(planMutex);
+	planList.clear();
+	planIndex.clear();
+	planCacheUsage = 0;
+}
+
+std::shared_ptr<FFTPlan> FFT::BuildPlan(size_t n, bool real)
+{
+	std::shared_ptr<FFTPlan> plan = std::make_shared<FFTPlan>();
+	plan->n = n;
+
+	if (real && n >= 2 && !(n & 1))
+	{
+		const size_t h = n / 2;
+		plan->kind = FFTPlan::Real;
+		plan->sub = GetPlan(h);
+		plan->twiddles.resize(h + 1);
+		for (size_t k = 0; k <= h; k++)
+		{
+			const double phi = (FFT_TWO_PI * k) / n;
+			plan->twiddles[k] = Complex(cos(phi), -sin(phi));
+		}
+	}
+	else if (IsPowerOfTwo(n))
+	{
+		plan->kind = FFTPlan::Radix2;
+
+		for (size_t i = 1, j = 0; i < n; i++)
+		{
+			size_t bit = n >> 1;
+			for (; j & bit; bit >>= 1)
+				j ^= bit;
+			j ^= bit;
+
+			if (i < j)
+			{
+				plan->swaps.push_back(static_cast<unsigned int>(i));
+				plan->swaps.push_back(static_cast<unsigned int>(j));
+			}
+		}
+
+		// w1[j] = e^(-2*pi*i*j/(2*half)) followed by w2[j] = e^(-2*pi*i*j/(4*half)) for every radix-4 pass
+		size_t stages = 0;
+		for (size_t m = n; m > 1; m >>= 1)
+			stages++;
+		for (size_t half = (stages & 1) ? 2 : 1; half < n; half <<= 2)
+		{
+			for (size_t j = 0; j < half; j++)
+			{
+				const double phi = (FFT_TWO_PI * j) / (2 * half);
+				plan->twiddles.push_back(Complex(cos(phi), -sin(phi)));
+			}
+			for (size_t j = 0; j < half; j++)
+			{
+				const double phi = (FFT_TWO_PI * j) / (4 * half);
+				plan->twiddles.push_back(Complex(cos(phi), -sin(phi)));
+			}
+		}
+	}
+	else if (Factorize(n, plan->factors))
+	{
+		plan->kind = FFTPlan::MixedRadix;
+		plan->twiddles.resize(n);
+		for (size_t k = 0; k < n; k++)
+		{
+			const double phi = (FFT_TWO_PI * k) / n;
+			plan->twiddles[k] = Complex(cos(phi), -sin(phi));
+		}
+	}
+	else
+	{
+		const size_t m = NextPowerOfTwo(2 * n - 1);
+		plan->kind = FFTPlan::Bluestein;
+		plan->sub = GetPlan(m);
+
+		plan->chirp.resize(n);
+		for (size_t k = 0; k < n; k++)
+		{
+			// k^2 mod 2n keeps the angle small so no precision is lost for large k
+			const unsigned long long kk = (static_cast<unsigned long long>(k) * k) % (2ull * n);
+			const double phi = (FFT_TWO_PI * 0.5 * static_cast<double>(kk)) / n;
+			plan->chirp[k] = Complex(cos(phi), -sin(phi));
+		}
+
+		plan->chirpSpectrum.resize(m);
+		plan->chirpSpectrum[0] = Complex(plan->chirp[0].re, -plan->chirp[0].im);
+		for (size_t k = 1; k < n; k++)
+			plan->chirpSpectrum[k] = plan->chirpSpectrum[m - k] = Complex(plan->chirp[k].re, -plan->chirp[k].im);
+		Radix2(*plan->sub, plan->chirpSpectrum.data(), false);
+	}
+
+	return plan;
+}
+
+void FFT::Forward(std::vector<Complex>& data)
+{
+	if (data.size() < 2)
+		return;
+	Transform(*GetPlan(data.size()), data.data(), false);
+}
+
+void FFT::Inverse(std::vector<Complex>& data)
+{
+	if (data.size() < 2)
+		return;
+	Transform(*GetPlan(data.size()), data.data(), true);
+}
+
+// even sizes use the N/2 trick: the even and odd samples are packed as real and imaginary part
+// of a half size complex transform which is then untangled with one more twiddle per bin
+// odd sizes are packed with a zero imaginary part
+void FFT::ForwardReal(const std::vector<float>& data, std::vector<Complex>& bins)
+{
+	const size_t n = data.size();
+	bins.resize(n);
+	if (n == 0)
+		return;
+
+	if (n & 1)
+	{
+		for (size_t i = 0; i < n; i++)
+			bins[i] = Complex(data[i], 0.0);
+		if (n > 1)
+			Transform(*GetPlan(n), bins.data(), false);
+		return;
+	}
+
+	std::shared_ptr<FFTPlan> plan = GetPlan(n, true);
+	const size_t h = n / 2;
+	Complex* z = GetScratch(ScratchReal, h);
+	for (size_t i = 0; i < h; i++)
+		z[i] = Complex(data[2 * i], data[2 * i + 1]);
+	if (h > 1)
+		Transform(*plan->sub, z, false);
+
+	for (size_t k = 0; k <= h; k++)
+	{
+		const Complex zk = z[k % h];
+		const Complex zc = Complex(z[(h - k) % h].re, -z[(h - k) % h].im);
+		const Complex even = Complex((zk.re + zc.re) * 0.5, (zk.im + zc.im) * 0.5);
+		const Complex odd = Complex((zk.im - zc.im) * 0.5, -(zk.re - zc.re) * 0.5); // (zk - zc) / 2i
+
+		Complex t = Complex(plan->twiddles[k]).mult(odd);
+		bins[k] = Complex(even.re + t.re, even.im + t.im);
+	}
+	for (size_t k = h + 1; k < n; k++)
+		bins[k] = Complex(bins[n - k].re, -bins[n - k].im);
+}
+
+// two real signals are packed as real and imaginary part of one complex transform z = x + iy,
+// the hermitian symmetry of real spectra separates them again:
+// X[k] = (Z[k] + conj(Z[N-k])) / 2 and Y[k] = (Z[k] - conj(Z[N-k])) / 2i
+// the transform runs in xbins, the separation is done pairwise for k and N-k so no extra buffer is needed
+void FFT::ForwardRealPair(const std::vector<float>& x, const std::vector<float>& y, std::vector<Complex>& xbins, std::vector<Complex>& ybins)
+{
+	const size_t n = x.size();
+	IM_ASSERT(y.size() == n);
+
+	xbins.resize(n);
+	ybins.resize(n);
+	for (size_t i = 0; i < n; i++)
+		xbins[i] = Complex(x[i], y[i]);
+	if (n > 1)
+		Transform(*GetPlan(n), xbins.data(), false);
+
+	for (size_t k = 0; k <= n / 2 && k < n; k++)
+	{
+		const size_t j = (n - k) % n;
+		const Complex zk = xbins[k];
+		const Complex zj = xbins[j];
+
+		xbins[k] = Complex((zk.re + zj.re) * 0.5, (zk.im - zj.im) * 0.5);
+		ybins[k] = Complex((zk.im + zj.im) * 0.5, -(zk.re - zj.re) * 0.5);
+		xbins[j] = Complex((zj.re + zk.re) * 0.5, (zj.im - zk.im) * 0.5);
+		ybins[j] = Complex((zj.im + zk.im) * 0.5, -(zj.re - zk.re) * 0.5);
+	}
+}
+
+void FFT::Transform(const FFTPlan& plan, Complex* data, bool inverse)
+{
+	if (plan.kind == FFTPlan::Radix2)
+	{
+		Radix2(plan, data, inverse);
+		return;
+	}
+
+	// the mixed radix and Bluestein transforms are forward only, the inverse is conj(fft(conj(x)))
+	const size_t n = plan.n;
+	if (inverse)
+		for (size_t i = 0; i < n; i++)
+			data[i].im = -data[i].im;
+
+	if (plan.kind == FFTPlan::MixedRadix)
+	{
+		Complex* in = GetScratch(ScratchMixedRadix, n);
+		for (size_t i = 0; i < n; i++)
+			in[i] = data[i];
+		MixedRadix(data, in, 1, plan.factors.data(), n, plan.twiddles);
+	}
+	else
+	{
+		Bluestein(plan, data);
+	}
+
+	if (inverse)
+		for (size_t i = 0; i < n; i++)
+			data[i].im = -data[i].im;
+}
+
+// recursive decimation in time transform (out of place)
+// the n/p sub transforms of every p-th input value are done first and then combined by a radix p butterfly
+// the twiddle table holds e^(-2*pi*i*k/N) for the full size N, fstride maps the current level onto it
+void FFT::MixedRadix(Complex* out, const Complex* in, size_t fstride, const int* factors, size_t n, const std::vector<Complex>& twiddles)
+{
+	const int p = factors[0];
+	const size_t m = n / p;
+
+	if (m == 1)
+	{
+		for (int q = 0; q < p; q++)
+			out[q] = in[q * fstride];
+	}
+	else if (n >= FFT_PARALLEL_SIZE)
+	{
+		// the sub transforms write to separate parts of out, large ones split further down the recursion
+		Parallel::For(0, p, 1, [&](size_t first, size_t last)
+		{
+			for (size_t q = first; q < last; q++)
+				MixedRadix(out + q * m, in + q * fstride, fstride * p, factors + 1, m, twiddles);
+		});
+	}
+	else
+	{
+		for (int q = 0; q < p; q++)
+			MixedRadix(out + q * m, in + q * fstride, fstride * p, factors + 1, m, twiddles);
+	}
+
+	if (n >= FFT_PARALLEL_SIZE)
+	{
+		Parallel::For(0, m, FFT_PARALLEL_GRAIN, [&](size_t first, size_t last)
+		{
+			Butterflies(out, p, m, fstride, first, last, twiddles);
+		});
+	}
+	else
+	{
+		Butterflies(out, p, m, fstride, 0, m, twiddles);
+	}
+}
+
+// radix p butterflies k = first .. last - 1 combining the p sub transforms of size m
+void FFT::Butterflies(Complex* out, int p, size_t m, size_t fstride, size_t first, size_t last, const std::vector<Complex>& twiddles)
+{
+	const size_t N = twiddles.size();
+
+	switch (p)
+	{
+	case 2:
+		for (size_t k = first; k < last; k++)
+		{
+			const Complex t = Complex(out[k + m]).mult(twiddles[k * fstride]);
+			out[k + m] = Complex(out[k].re - t.re, out[k].im - t.im);
+			out[k].add(t);
+		}
+		break;
+	case 4:
+		for (size_t k = first; k < last; k++)
+		{
+			const Complex s0 = Complex(out[k + m]).mult(twiddles[k * fstride]);
+			const Complex s1 = Complex(out[k + 2 * m]).mult(twiddles[2 * k * fstride]);
+			const Complex s2 = Complex(out[k + 3 * m]).mult(twiddles[3 * k * fstride]);
+			const Complex s3 = Complex(s0.re + s2.re, s0.im + s2.im);
+			const Complex s4 = Complex(s0.re - s2.re, s0.im - s2.im);
+			const Complex s5 = Complex(out[k].re - s1.re, out[k].im - s1.im);
+			const Complex s6 = Complex(out[k].re + s1.re, out[k].im + s1.im);
+
+			out[k] = Complex(s6.re + s3.re, s6.im + s3.im);
+			out[k + 2 * m] = Complex(s6.re - s3.re, s6.im - s3.im);
+			out[k + m] = Complex(s5.re + s4.im, s5.im - s4.re);
+			out[k + 3 * m] = Complex(s5.re - s4.im, s5.im + s4.re);
+		}
+		break;
+	default:
+	{
+		// generic radix (3, 5 and 7), O(p^2) per butterfly which is fine for these small radices
+		Complex scratch[7];
+		for (size_t k = first; k < last; k++)
+		{
+			for (int q = 0; q < p; q++)
+				scratch[q] = out[k + q * m];
+
+			for (int q1 = 0; q1 < p; q1++)
+			{
+				const size_t u = k + q1 * m;
+				size_t twidx = 0;
+				Complex sum = scratch[0];
+				for (int q = 1; q < p; q++)
+				{
+					twidx += fstride * u;
+					if (twidx >= N)
+						twidx %= N;
+					sum.add(Complex(scratch[q]).mult(twiddles[twidx]));
+				}
+				out[u] = sum;
+			}
+		}
+		break;
+	}
+	}
+}
+
+// Bluestein's chirp-z algorithm expresses the dft of any size n as a convolution,
+// X[k] = w[k] * sum(x[j] * w[j] * conj(w[k - j])) with the chirp w[k] = e^(-i*pi*k^2/n),
+// which is evaluated with power of two transforms of at least 2n - 1 values
+// the transform of the conjugated chirp is part of the plan, so only two transforms are left per call
+void FFT::Bluestein(const FFTPlan& plan, Complex* data)
+{
+	const size_t n = plan.n;
+	const size_t m = plan.sub->n;
+	Complex* a = GetScratch(ScratchBluestein, m);
+
+	Multiply(a, data, plan.chirp.data(), n, 1.0);
+	for (size_t k = n; k < m; k++)
+		a[k] = Complex(0.0, 0.0);
+
+	Radix2(*plan.sub, a, false);
+	Multiply(a, a, plan.chirpSpectrum.data(), m, 1.0);
+	Radix2(*plan.sub, a, true);
+
+	Multiply(data, a, plan.chirp.data(), n, 1.0 / m);
+}
+
+// out[k] = a[k] * b[k] * scale
+void FFT::Multiply(Complex* out, const Complex* a, const Complex* b, size_t n, double scale)
+{
+	const FFTKernels& kernels = FFTKernels::Get();
+	if (n < FFT_PARALLEL_SIZE)
+	{
+		kernels.Multiply(out, a, b, n, scale);
+		return;
+	}
+
+	Parallel::For(0, n, FFT_PARALLEL_GRAIN, [&](size_t first, size_t last)
+	{
+		kernels.Multiply(out + first, a + first, b + first, last - first, scale);
+	});
+}
+
+// the swapped pairs are disjoint, so large permutations are split across the cores
+void FFT::BitReverse(const FFTPlan& plan, Complex* data)
+{
+	const unsigned int* swaps = plan.swaps.data();
+	const size_t pairs = plan.swaps.size() / 2;
+
+	auto swap = [swaps, data](size_t first, size_t last)
+	{
+		for (size_t s = 2 * first; s < 2 * last; s += 2)
+		{
+			Complex tmp = data[swaps[s]];
+			data[swaps[s]] = data[swaps[s + 1]];
+			data[swaps[s + 1]] = tmp;
+		}
+	};
+
+	if (plan.n < FFT_PARALLEL_SIZE)
+		swap(0, pairs);
+	else
+		Parallel::For(0, pairs, FFT_PARALLEL_GRAIN, swap);
+}
+
+// iterative decimation in time transform for power of two sizes
+// after the bit reversal two consecutive radix-2 stages are fused into one radix-4 pass,
+// so the data is walked log4(n) times instead of log2(n) times.
+// a single radix-2 pass is done first if log2(n) is odd
+// for large sizes every pass is split across the cores, by blocks while there are enough of them,
+// by butterflies within the blocks for the last passes
+void FFT::Radix2(const FFTPlan& plan, Complex* data, bool inverse)
+{
+	const size_t n = plan.n;
+	if (n < 2)
+		return;
+
+	BitReverse(plan, data);
+
+	const bool parallel = n >= FFT_PARALLEL_SIZE;
+	size_t half = 1;
+	size_t stages = 0;
+	for (size_t m = n; m > 1; m >>= 1)
+		stages++;
+
+	if (stages & 1)
+	{
+		auto pass = [data](size_t first, size_t last)
+		{
+			for (size_t b = 2 * first; b < 2 * last; b += 2)
+			{
+				const Complex u = data[b];
+				const Complex v = data[b + 1];
+				data[b] = Complex(u.re + v.re, u.im + v.im);
+				data[b + 1] = Complex(u.re - v.re, u.im - v.im);
+			}
+		};
+
+		if (parallel)
+			Parallel::For(0, n / 2, FFT_PARALLEL_GRAIN, pass);
+		else
+			pass(0, n / 2);
+		half = 2;
+	}
+
+	// radix-4 pass covering the radix-2 stages of size 2*half and 4*half
+	const FFTKernels& kernels = FFTKernels::Get();
+	const Complex* tw = plan.twiddles.data();
+	for (; half < n; half <<= 2)
+	{
+		const Complex* tw1 = tw;
+		const Complex* tw2 = tw + half;
+		tw += 2 * half;
+
+		const size_t block = 4 * half;
+		const size_t blocks = n / block;
+		if (!parallel)
+		{
+			kernels.Radix4Pass(data, n, half, half, tw1, tw2, inverse);
+		}
+		else if (blocks >= Parallel::GetThreadCount())
+		{
+			const size_t grain = (FFT_PARALLEL_GRAIN + block - 1) / block;
+			Parallel::For(0, blocks, grain, [&](size_t first, size_t last)
+			{
+				kernels.Radix4Pass(data + first * block, (last - first) * block, half, half, tw1, tw2, inverse);
+			});
+		}
+		else
+		{
+			// butterflies are split in pairs, the vector kernels need an even count
+			for (size_t b = 0; b < n; b += block)
+			{
+				Parallel::For(0, half / 2, FFT_PARALLEL_GRAIN / 2, [&](size_t first, size_t last)
+				{
+					kernels.Radix4Pass(data + b + 2 * first, block, half, 2 * (last - first), tw1 + 2 * first, tw2 + 2 * first, inverse);
+				});
+			}
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include "fourier.h"
+
+// everything a transform of one size needs that does not depend on the data:
+// twiddle tables, the bit reversal permutation and the factorization.
+// plans are built once per size, kept in a process-wide cache (see FFT::GetPlan) and never changed afterwards
+struct FFTPlan
+{
+	enum Kind
+	{
+		Radix2,     // power of two, iterative radix-2/4
+		MixedRadix, // factors 2, 3, 5 and 7, recursive
+		Bluestein,  // any other size, chirp-z on top of a power of two plan
+		Real,       // real input of even size, N/2 trick on top of a complex plan of half the size
+	};
+
+	size_t n = 0;
+	Kind kind = Radix2;
+	std::vector<unsigned int> swaps;      // Radix2: index pairs swapped by the bit reversal
+	std::vector<int> factors;             // MixedRadix: radices of n
+	std::vector<Complex> twiddles;        // Radix2: w1/w2 per radix-4 pass, MixedRadix: e^(-2*pi*i*k/n), Real: e^(-2*pi*i*k/n) for k <= n/2
+	std::vector<Complex> chirp;           // Bluestein: e^(-i*pi*k^2/n)
+	std::vector<Complex> chirpSpectrum;   // Bluestein: transform of the conjugated chirp
+	std::shared_ptr<FFTPlan> sub;         // Bluestein: power of two plan, Real: complex plan of n/2
+
+	size_t GetMemoryUsage() const;
+};
+
+// fast fourier transform used by fourier::DFT
+// transforms work in place on a set of complex values and are not normalized,
+// ie. the caller needs to divide by N where the discrete fourier transform requires it
+// any size is supported:
+// - powers of two use the iterative radix-2/4 transform
+// - sizes made of the factors 2, 3, 5 and 7 use the recursive mixed radix transform
+// - sizes with a larger prime factor use Bluestein's chirp-z algorithm on top of a power of two transform
+// real input is packed into complex values, so only half the work of a complex transform is needed
+// repeated transforms of the same size reuse the cached plan and do neither trigonometry nor allocations
+// large transforms are split across the cores (see parallel.h), any number of transforms may run at the same time
+class FFT
+{
+private:
+	static std::shared_ptr<FFTPlan> BuildPlan(size_t n, bool real);
+	static void BitReverse(const FFTPlan& plan, Complex* data);
+	static void Radix2(const FFTPlan& plan, Complex* data, bool inverse);
+	static void MixedRadix(Complex* out, const Complex* in, size_t fstride, const int* factors, size_t n, const std::vector<Complex>& twiddles);
+	static void Butterflies(Complex* out, int p, size_t m, size_t fstride, size_t first, size_t last, const std::vector<Complex>& twiddles);
+	static void Bluestein(const FFTPlan& plan, Complex* data);
+	static void Multiply(Complex* out, const Complex* a, const Complex* b, size_t n, double scale);
+	static void Transform(const FFTPlan& plan, Complex* data, bool inverse);
+
+public:
+	static bool IsPowerOfTwo(size_t n);
+	static size_t NextPowerOfTwo(size_t n);
+	static bool Factorize(size_t n, std::vector<int>& factors);
+	static void Forward(std::vector<Complex>& data);
+	static void Inverse(std::vector<Complex>& data);
+	static void ForwardReal(const std::vector<float>& data, std::vector<Complex>& bins); // all N bins, the upper half is mirrored
+	static void ForwardRealPair(const std::vector<float>& x, const std::vector<float>& y, std::vector<Complex>& xbins, std::vector<Complex>& ybins); // x and y need the same size
+
+	// plan cache, least recently used plans are dropped once the memory limit is exceeded
+	static std::shared_ptr<FFTPlan> GetPlan(size_t n, bool real = false);
+	static void SetPlanCacheLimit(size_t bytes);
+	static size_t GetPlanCacheUsage();
+	static void ClearPlanCache();
+};
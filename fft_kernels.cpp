@@ -0,0 +1,279 @@
+#include "fft_kernels.h"
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FFT_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// msvc accepts any intrinsic, gcc and clang need the instruction set enabled per function
+#if defined(FFT_X86) && !defined(_MSC_VER)
+#define FFT_TARGET(x) __attribute__((target(x)))
+#else
+#define FFT_TARGET(x)
+#endif
+
+static void Radix4PassScalar(Complex* data, size_t n, size_t half, size_t count, const Complex* tw1, const Complex* tw2, bool inverse)
+{
+	const double sign = inverse ? -1.0 : 1.0;
+
+	for (size_t b = 0; b < n; b += 4 * half)
+	{
+		for (size_t j = 0; j < count; j++)
+		{
+			const Complex w1 = Complex(tw1[j].re, sign * tw1[j].im);
+			const Complex w2 = Complex(tw2[j].re, sign * tw2[j].im);
+
+			Complex* x = data + b + j;
+			const Complex a0 = x[0];
+			const Complex a1 = Complex(x[half].re * w1.re - x[half].im * w1.im, x[half].re * w1.im + x[half].im * w1.re);
+			const Complex a2 = x[2 * half];
+			const Complex a3 = Complex(x[3 * half].re * w1.re - x[3 * half].im * w1.im, x[3 * half].re * w1.im + x[3 * half].im * w1.re);
+
+			const Complex t0 = Complex(a0.re + a1.re, a0.im + a1.im);
+			const Complex t1 = Complex(a0.re - a1.re, a0.im - a1.im);
+			const Complex t2 = Complex(a2.re + a3.re, a2.im + a3.im);
+			const Complex t3 = Complex(a2.re - a3.re, a2.im - a3.im);
+
+			// (-i * w2) for the forward transform becomes (+i * w2) for the inverse one
+			const Complex u2 = Complex(t2.re * w2.re - t2.im * w2.im, t2.re * w2.im + t2.im * w2.re);
+			Complex u3 = Complex(t3.re * w2.re - t3.im * w2.im, t3.re * w2.im + t3.im * w2.re);
+			u3 = inverse ? Complex(-u3.im, u3.re) : Complex(u3.im, -u3.re);
+
+			x[0] = Complex(t0.re + u2.re, t0.im + u2.im);
+			x[2 * half] = Complex(t0.re - u2.re, t0.im - u2.im);
+			x[half] = Complex(t1.re + u3.re, t1.im + u3.im);
+			x[3 * half] = Complex(t1.re - u3.re, t1.im - u3.im);
+		}
+	}
+}
+
+static void MultiplyScalar(Complex* out, const Complex* a, const Complex* b, size_t n, double scale)
+{
+	for (size_t k = 0; k < n; k++)
+	{
+		const double re = a[k].re * b[k].re - a[k].im * b[k].im;
+		const double im = a[k].re * b[k].im + a[k].im * b[k].re;
+		out[k] = Complex(re * scale, im * scale);
+	}
+}
+
+#ifdef FFT_X86
+
+// Complex is two interleaved doubles, so one __m128d holds one value and one __m256d holds two
+
+// (ar * br - ai * bi, ar * bi + ai * br)
+static inline __m128d MulSSE2(__m128d a, __m128d b)
+{
+	const __m128d neg = _mm_set_pd(0.0, -0.0);
+	const __m128d br = _mm_unpacklo_pd(b, b);
+	const __m128d bi = _mm_unpackhi_pd(b, b);
+	const __m128d as = _mm_shuffle_pd(a, a, 1);
+	return _mm_add_pd(_mm_mul_pd(a, br), _mm_xor_pd(_mm_mul_pd(as, bi), neg));
+}
+
+static void Radix4PassSSE2(Complex* data, size_t n, size_t half, size_t count, const Complex* tw1, const Complex* tw2, bool inverse)
+{
+	// conj flips the sign of the imaginary part, rot turns the swapped (im, re) into -i * u (forward) or +i * u (inverse)
+	const __m128d conj = inverse ? _mm_set_pd(-0.0, 0.0) : _mm_setzero_pd();
+	const __m128d rot = inverse ? _mm_set_pd(0.0, -0.0) : _mm_set_pd(-0.0, 0.0);
+
+	for (size_t b = 0; b < n; b += 4 * half)
+	{
+		for (size_t j = 0; j < count; j++)
+		{
+			const __m128d w1 = _mm_xor_pd(_mm_loadu_pd(&tw1[j].re), conj);
+			const __m128d w2 = _mm_xor_pd(_mm_loadu_pd(&tw2[j].re), conj);
+
+			double* x = &data[b + j].re;
+			const __m128d a0 = _mm_loadu_pd(x);
+			const __m128d a1 = MulSSE2(_mm_loadu_pd(x + 2 * half), w1);
+			const __m128d a2 = _mm_loadu_pd(x + 4 * half);
+			const __m128d a3 = MulSSE2(_mm_loadu_pd(x + 6 * half), w1);
+
+			const __m128d t0 = _mm_add_pd(a0, a1);
+			const __m128d t1 = _mm_sub_pd(a0, a1);
+			const __m128d t2 = _mm_add_pd(a2, a3);
+			const __m128d t3 = _mm_sub_pd(a2, a3);
+
+			const __m128d u2 = MulSSE2(t2, w2);
+			__m128d u3 = MulSSE2(t3, w2);
+			u3 = _mm_xor_pd(_mm_shuffle_pd(u3, u3, 1), rot);
+
+			_mm_storeu_pd(x, _mm_add_pd(t0, u2));
+			_mm_storeu_pd(x + 4 * half, _mm_sub_pd(t0, u2));
+			_mm_storeu_pd(x + 2 * half, _mm_add_pd(t1, u3));
+			_mm_storeu_pd(x + 6 * half, _mm_sub_pd(t1, u3));
+		}
+	}
+}
+
+static void MultiplySSE2(Complex* out, const Complex* a, const Complex* b, size_t n, double scale)
+{
+	const __m128d s = _mm_set1_pd(scale);
+	for (size_t k = 0; k < n; k++)
+		_mm_storeu_pd(&out[k].re, _mm_mul_pd(MulSSE2(_mm_loadu_pd(&a[k].re), _mm_loadu_pd(&b[k].re)), s));
+}
+
+FFT_TARGET("avx2,fma")
+static inline __m256d MulAVX2(__m256d a, __m256d b)
+{
+	const __m256d br = _mm256_movedup_pd(b);
+	const __m256d bi = _mm256_permute_pd(b, 0xF);
+	const __m256d as = _mm256_permute_pd(a, 0x5);
+	return _mm256_fmaddsub_pd(a, br, _mm256_mul_pd(as, bi));
+}
+
+FFT_TARGET("avx2,fma")
+static void Radix4PassAVX2(Complex* data, size_t n, size_t half, size_t count, const Complex* tw1, const Complex* tw2, bool inverse)
+{
+	// two butterflies per iteration, the first pass of an even number of stages has only one
+	if (half < 2)
+	{
+		Radix4PassSSE2(data, n, half, count, tw1, tw2, inverse);
+		return;
+	}
+
+	const __m256d conj = inverse ? _mm256_set_pd(-0.0, 0.0, -0.0, 0.0) : _mm256_setzero_pd();
+	const __m256d rot = inverse ? _mm256_set_pd(0.0, -0.0, 0.0, -0.0) : _mm256_set_pd(-0.0, 0.0, -0.0, 0.0);
+
+	for (size_t b = 0; b < n; b += 4 * half)
+	{
+		for (size_t j = 0; j < count; j += 2)
+		{
+			const __m256d w1 = _mm256_xor_pd(_mm256_loadu_pd(&tw1[j].re), conj);
+			const __m256d w2 = _mm256_xor_pd(_mm256_loadu_pd(&tw2[j].re), conj);
+
+			double* x = &data[b + j].re;
+			const __m256d a0 = _mm256_loadu_pd(x);
+			const __m256d a1 = MulAVX2(_mm256_loadu_pd(x + 2 * half), w1);
+			const __m256d a2 = _mm256_loadu_pd(x + 4 * half);
+			const __m256d a3 = MulAVX2(_mm256_loadu_pd(x + 6 * half), w1);
+
+			const __m256d t0 = _mm256_add_pd(a0, a1);
+			const __m256d t1 = _mm256_sub_pd(a0, a1);
+			const __m256d t2 = _mm256_add_pd(a2, a3);
+			const __m256d t3 = _mm256_sub_pd(a2, a3);
+
+			const __m256d u2 = MulAVX2(t2, w2);
+			__m256d u3 = MulAVX2(t3, w2);
+			u3 = _mm256_xor_pd(_mm256_permute_pd(u3, 0x5), rot);
+
+			_mm256_storeu_pd(x, _mm256_add_pd(t0, u2));
+			_mm256_storeu_pd(x + 4 * half, _mm256_sub_pd(t0, u2));
+			_mm256_storeu_pd(x + 2 * half, _mm256_add_pd(t1, u3));
+			_mm256_storeu_pd(x + 6 * half, _mm256_sub_pd(t1, u3));
+		}
+	}
+}
+
+FFT_TARGET("avx2,fma")
+static void MultiplyAVX2(Complex* out, const Complex* a, const Complex* b, size_t n, double scale)
+{
+	const __m256d s = _mm256_set1_pd(scale);
+	size_t k = 0;
+	for (; k + 2 <= n; k += 2)
+		_mm256_storeu_pd(&out[k].re, _mm256_mul_pd(MulAVX2(_mm256_loadu_pd(&a[k].re), _mm256_loadu_pd(&b[k].re)), s));
+	if (k < n)
+		MultiplySSE2(out + k, a + k, b + k, n - k, scale);
+}
+
+static void CpuId(int info[4], int leaf, int subleaf)
+{
+#if defined(_MSC_VER)
+	__cpuidex(info, leaf, subleaf);
+#else
+	unsigned int a = 0, b = 0, c = 0, d = 0;
+	__cpuid_count(leaf, subleaf, a, b, c, d);
+	info[0] = (int)a; info[1] = (int)b; info[2] = (int)c; info[3] = (int)d;
+#endif
+}
+
+// the os has to save the ymm registers on a context switch, otherwise AVX must not be used
+FFT_TARGET("xsave")
+static unsigned long long XGetBV()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int lo = 0, hi = 0;
+	__asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+	return ((unsigned long long)hi << 32) | lo;
+#endif
+}
+
+static FFTKernels::Level DetectLevel()
+{
+	int info[4];
+	CpuId(info, 0, 0);
+	const int maxLeaf = info[0];
+
+	CpuId(info, 1, 0);
+	const bool sse2 = (info[3] & (1 << 26)) != 0;
+	const bool fma = (info[2] & (1 << 12)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+
+	bool avx2 = false;
+	if (maxLeaf >= 7)
+	{
+		CpuId(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+
+	if (osxsave && avx && avx2 && fma && (XGetBV() & 6) == 6)
+		return FFTKernels::AVX2;
+	if (sse2)
+		return FFTKernels::SSE2;
+	return FFTKernels::Scalar;
+}
+
+#else
+
+static FFTKernels::Level DetectLevel()
+{
+	return FFTKernels::Scalar;
+}
+
+#endif
+
+static const FFTKernels kernels[] =
+{
+	{ FFTKernels::Scalar, "Scalar", Radix4PassScalar, MultiplyScalar },
+#ifdef FFT_X86
+	{ FFTKernels::SSE2, "SSE2", Radix4PassSSE2, MultiplySSE2 },
+	{ FFTKernels::AVX2, "AVX2/FMA", Radix4PassAVX2, MultiplyAVX2 },
+#endif
+};
+
+static std::atomic<const FFTKernels*> selected(nullptr);
+
+FFTKernels::Level FFTKernels::GetSupportedLevel()
+{
+	static const Level level = DetectLevel();
+	return level;
+}
+
+const FFTKernels& FFTKernels::Get()
+{
+	const FFTKernels* k = selected.load();
+	if (k == nullptr)
+	{
+		k = &kernels[GetSupportedLevel()];
+		selected.store(k);
+	}
+	return *k;
+}
+
+void FFTKernels::Select(Level level)
+{
+	if (level > GetSupportedLevel())
+		level = GetSupportedLevel();
+	selected = &kernels[level];
+}
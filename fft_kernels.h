@@ -0,0 +1,35 @@
+#pragma once
+#include "fourier.h"
+
+// inner loops of the FFT, one implementation per instruction set.
+// the best set supported by the cpu (and the os) is picked once at startup via cpuid,
+// the scalar kernels are the fallback for everything else.
+// the vector kernels do the same operations in the same order as the scalar ones,
+// except that AVX2 fuses multiply and add (FMA). the results therefore differ only in the last bits,
+// the relative error of a transform stays below 1e-12 of the largest bin for any size up to 1e6,
+// ie. the WaveletStruct output is the same within float precision for all kernel sets
+struct FFTKernels
+{
+	enum Level
+	{
+		Scalar,
+		SSE2,
+		AVX2, // AVX2 + FMA
+	};
+
+	Level level;
+	const char* name;
+
+	// one radix-4 pass (two fused radix-2 stages) of the iterative power of two transform
+	// tw1/tw2 hold the forward twiddles of the pass, they are conjugated for the inverse transform
+	// only the butterflies j < count of every block of 4 * half values are done, count is even if half > 1,
+	// so a large pass can be split into several calls
+	void (*Radix4Pass)(Complex* data, size_t n, size_t half, size_t count, const Complex* tw1, const Complex* tw2, bool inverse);
+
+	// out[k] = a[k] * b[k] * scale, out may be a
+	void (*Multiply)(Complex* out, const Complex* a, const Complex* b, size_t n, double scale);
+
+	static const FFTKernels& Get();
+	static Level GetSupportedLevel();
+	static void Select(Level level); // forces a lower level, eg. to compare the results, is clamped to the supported one
+};
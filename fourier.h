@@ -13,12 +13,28 @@
 #include <stdint.h>         // intptr_t
 #endif
 #include <vector>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "sincos.h"
 
 #define MAX_FREQUENCY 1000
 #define MAX_PLOT 20000
 #define MAX_NODES 1000
+#define MAX_SERIES_NODES 100000
+#define MAX_HARMONICS 1000000
 #define HALF_LEN 100.0f
 #define NUM_DEMODULATOR_GRAPHS 6
+#define TRACE_VERTEX_BUDGET 100000 // default of the vertices the trace may take per frame
+#define TRACE_BATCH 8192 // points per polyline of the trace, 4 vertices each stay within a 16 bit draw command
+#define SPSC_CACHE_LINE 64
+#define CURVE_SAMPLE_RATE 1000 // samples per second of the curve worker
+#define PLOT_POINTS_PER_PIXEL 2 // the scrolling plots are reduced to the min/max of every pixel column beyond this
+#define PLOT_PYRAMID_FACTOR 8 // samples per block of the first level of a plot pyramid, blocks per block above
+#define LOD_MIN_RADIUS 1.0f // circles of a smaller radius (in pixels) are not drawn, a run of them is drawn as one edge
 
 static const double PI = acos(-1.0f);
 static const double TWO_PI = 2.0f * PI;
@@ -495,13 +511,146 @@ struct ExampleAppLog
 };
 
 // utility structure for realtime plot
+// running extremum of the last values of a stream (a monotonic queue): the queue holds the values that can still
+// become the extremum, ie. every value is more extreme than all that came after it, so the front is the extremum
+// of the window. a value is pushed and popped at most once, O(1) amortized per value
+struct SlidingExtremum {
+	struct Entry {
+		unsigned int Seq;
+		float Value;
+	};
+	ImVector<Entry> Ring;
+	int Front;
+	int Count;
+	float Sign; // 1 tracks the maximum, -1 the minimum
+	SlidingExtremum(float sign = 1.0f) {
+		Front = 0;
+		Count = 0;
+		Sign = sign;
+	}
+	void Reset(int capacity) {
+		Ring.resize(capacity);
+		Front = 0;
+		Count = 0;
+	}
+	// adds the value of sample seq and drops the samples older than window
+	void Add(unsigned int seq, float value, int window) {
+		const int capacity = Ring.Size;
+		while (Count > 0 && Sign * Ring[(Front + Count - 1) % capacity].Value <= Sign * value)
+			Count--;
+		while (Count > 0 && seq - Ring[Front].Seq >= static_cast<unsigned int>(window)) {
+			Front = (Front + 1) % capacity;
+			Count--;
+		}
+		Ring[(Front + Count) % capacity] = { seq, value };
+		Count++;
+	}
+	float Get() const {
+		return Ring[Front].Value;
+	}
+};
+
+// summary of a block of samples of a scrolling buffer, X0 and X1 are the x of its first and last sample
+struct PlotSummary {
+	float X0;
+	float X1;
+	float Min;
+	float Max;
+	float Mean;
+	bool MaxFirst; // the maximum came before the minimum
+};
+
+// mipmap of the samples of a scrolling buffer: a block of level 0 summarizes PLOT_PYRAMID_FACTOR samples, a block of
+// level k + 1 PLOT_PYRAMID_FACTOR blocks of level k. every level keeps the blocks of (about) the samples the buffer
+// holds in a ring, the block n (counted since the last erase) at n % capacity. AddPoint completes the blocks
+// incrementally, O(1) amortized per sample, a plot draws from the level that matches its zoom
+struct PlotPyramid {
+	struct Level {
+		ImVector<PlotSummary> Ring;
+		PlotSummary Partial; // the block being filled
+		int Filled;          // of the partial block
+		unsigned int Count;  // complete blocks since the last erase
+	};
+	std::vector<Level> Levels;
+	void Reset(int maxSize) {
+		Levels.clear();
+		for (int capacity = maxSize / PLOT_PYRAMID_FACTOR; capacity >= PLOT_PYRAMID_FACTOR; capacity /= PLOT_PYRAMID_FACTOR) {
+			Levels.emplace_back();
+			Level& level = Levels.back();
+			level.Ring.resize(capacity);
+			level.Filled = 0;
+			level.Count = 0;
+		}
+	}
+	void Clear() {
+		for (Level& level : Levels) {
+			level.Filled = 0;
+			level.Count = 0;
+		}
+	}
+	void Add(float x, float y) {
+		PlotSummary sample = { x, x, y, y, y, false };
+		for (Level& level : Levels) {
+			Merge(level.Partial, level.Filled, sample);
+			if (++level.Filled < PLOT_PYRAMID_FACTOR)
+				return;
+			sample = level.Partial;
+			level.Ring[level.Count % level.Ring.Size] = sample;
+			level.Count++;
+			level.Filled = 0;
+		}
+	}
+	// the samples (PLOT_PYRAMID_FACTOR ^ (level + 1)) a block of the level summarizes
+	static int BlockSize(int level) {
+		int size = PLOT_PYRAMID_FACTOR;
+		for (int i = 0; i < level; i++)
+			size *= PLOT_PYRAMID_FACTOR;
+		return size;
+	}
+	// the first block of the level still held
+	unsigned int First(int level) const {
+		const Level& l = Levels[level];
+		return l.Count > static_cast<unsigned int>(l.Ring.Size) ? l.Count - l.Ring.Size : 0;
+	}
+	const PlotSummary& Get(int level, unsigned int block) const {
+		return Levels[level].Ring[block % Levels[level].Ring.Size];
+	}
+	static void Merge(PlotSummary& block, int filled, const PlotSummary& child) {
+		if (filled == 0) {
+			block = child;
+			return;
+		}
+		const bool lower = child.Min < block.Min;
+		const bool higher = child.Max > block.Max;
+		if (lower && higher)
+			block.MaxFirst = child.MaxFirst;
+		else if (lower)
+			block.MaxFirst = true;
+		else if (higher)
+			block.MaxFirst = false;
+		block.X1 = child.X1;
+		block.Min = lower ? child.Min : block.Min;
+		block.Max = higher ? child.Max : block.Max;
+		block.Mean += (child.Mean - block.Mean) / (filled + 1); // the children are of equal size
+	}
+};
+
 struct ScrollingBuffer {
 	int MaxSize;
 	int Offset;
+	unsigned int Revision; // counts the changes, equal revisions mean equal data
+	unsigned int Count;    // samples added since the last erase
+	int Window;            // the newest samples the extrema of y cover, 0 does not track them
+	SlidingExtremum Min;
+	SlidingExtremum Max;
+	PlotPyramid Pyramid;   // no levels unless enabled
 	ImVector<ImVec2> Data;
-	ScrollingBuffer(int max_size = 2000) {
+	ScrollingBuffer(int max_size = 2000) : Min(-1.0f), Max(1.0f) {
 		MaxSize = max_size;
 		Offset = 0;
+		Revision = 0;
+		Count = 0;
+		Window = 0;
 		Data.reserve(MaxSize);
 	}
 	void AddPoint(float x, float y) {
@@ -511,13 +660,203 @@ struct ScrollingBuffer {
 			Data[Offset] = ImVec2(x, y);
 			Offset = (Offset + 1) % MaxSize;
 		}
+		if (Window > 0) {
+			Min.Add(Count, y, Window);
+			Max.Add(Count, y, Window);
+		}
+		if (!Pyramid.Levels.empty())
+			Pyramid.Add(x, y);
+		Count++;
+		Revision++;
 	}
 	void Erase() {
 		if (Data.size() > 0) {
 			Data.shrink(0);
 			Offset = 0;
+			Count = 0;
+			Min.Reset(Window);
+			Max.Reset(Window);
+			Pyramid.Clear();
+			Revision++;
+		}
+	}
+	const ImVec2& Newest() const {
+		return Data[Offset > 0 ? Offset - 1 : Data.Size - 1];
+	}
+	// tracks the extrema of the newest samples from now on, a changed window is rebuilt from the samples kept
+	void SetWindow(int window) {
+		window = window < 0 ? 0 : window > MaxSize ? MaxSize : window;
+		if (window == Window)
+			return;
+		Window = window;
+		Min.Reset(Window);
+		Max.Reset(Window);
+		if (Window == 0)
+			return;
+		const int n = Data.Size < Window ? Data.Size : Window;
+		for (int i = Data.Size - n; i < Data.Size; i++) {
+			const unsigned int seq = Count - Data.Size + i;
+			const float y = Data[(Offset + i) % Data.Size].y;
+			Min.Add(seq, y, Window);
+			Max.Add(seq, y, Window);
 		}
 	}
+	// builds the pyramid of the samples from now on, the samples before are not summarized
+	void EnablePyramid() {
+		if (Pyramid.Levels.empty())
+			Pyramid.Reset(MaxSize);
+	}
+	// the extrema of y of the window, only valid with a window and samples
+	float MinY() const {
+		return Min.Get();
+	}
+	float MaxY() const {
+		return Max.Get();
+	}
+};
+
+// lock-free ring of one producer and one consumer thread in front of a ScrollingBuffer, so the samples can be
+// generated on a thread of their own. the producer only writes Head, the consumer only Tail, each on a cache line
+// of its own together with the data only its side touches (eg. the producer's copy of Tail), so a sample does not
+// move a cache line back and forth. AddPoint is wait-free, a full ring drops the sample.
+// Drain moves the samples added since into the consumer's scrolling buffer, that buffer is the snapshot to plot
+struct alignas(SPSC_CACHE_LINE) SpscScrollingBuffer {
+	std::vector<ImVec2> Ring;
+	uint32_t Mask;
+	alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> Head; // next sample to write
+	uint32_t TailCache;
+	std::atomic<uint32_t> Dropped;
+	alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> Tail; // next sample to read
+	SpscScrollingBuffer(int capacity = 4096) {
+		uint32_t size = 1;
+		while (size < static_cast<uint32_t>(capacity))
+			size <<= 1;
+		Ring.resize(size);
+		Mask = size - 1;
+		Head = 0;
+		TailCache = 0;
+		Dropped = 0;
+		Tail = 0;
+	}
+	// producer
+	bool AddPoint(float x, float y) {
+		const uint32_t head = Head.load(std::memory_order_relaxed);
+		if (head - TailCache > Mask) {
+			TailCache = Tail.load(std::memory_order_acquire);
+			if (head - TailCache > Mask) {
+				Dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+		}
+		Ring[head & Mask] = ImVec2(x, y);
+		Head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+	// consumer, returns the number of samples moved
+	int Drain(ScrollingBuffer& snapshot) {
+		const uint32_t tail = Tail.load(std::memory_order_relaxed);
+		const uint32_t head = Head.load(std::memory_order_acquire);
+		for (uint32_t i = tail; i != head; i++)
+			snapshot.AddPoint(Ring[i & Mask].x, Ring[i & Mask].y);
+		Tail.store(head, std::memory_order_release);
+		return static_cast<int>(head - tail);
+	}
+	// consumer, drops the samples not drained yet
+	void Discard() {
+		Tail.store(Head.load(std::memory_order_acquire), std::memory_order_release);
+	}
+};
+
+// online simplification of a polyline (the sleeve of zhao and saalfeld): a point is kept only when no line from the
+// last kept point (the anchor) passes within Tolerance of every point since, so a dropped point is never further
+// than Tolerance from the simplified line. the sleeve is the range of directions from the anchor that pass all of
+// them, every point narrows it in O(1). a Tolerance of 0 keeps every point
+struct PolylineSimplifier {
+	float Tolerance;
+	ImVec2 Last;     // the last point added, the live end of the simplified line
+	int Added;
+	int Kept;
+	ImVec2 Anchor;
+	float Direction; // of the first point after the anchor, the sleeve is relative to it
+	float Low;
+	float High;
+	float Farthest;  // distance of the farthest point from the anchor, going back along the line is kept as well
+	bool HasAnchor;
+	bool HasSleeve;
+	PolylineSimplifier(float tolerance = 0.5f) {
+		Tolerance = tolerance;
+		Reset();
+	}
+	void Reset() {
+		Last = ImVec2(0.0f, 0.0f);
+		Added = 0;
+		Kept = 0;
+		HasAnchor = false;
+		HasSleeve = false;
+	}
+	// returns true if a point has to be kept, either the previous one or (the first time) p itself
+	bool Add(ImVec2 p, ImVec2& kept) {
+		Added++;
+		if (!HasAnchor || Tolerance <= 0.0f) {
+			Last = p;
+			return Keep(p, kept);
+		}
+		if (Fits(p)) {
+			Last = p;
+			return false;
+		}
+		const ImVec2 previous = Last;
+		Keep(previous, kept);
+		Fits(p);
+		Last = p;
+		return true;
+	}
+	// keeps the live end, eg. when the line is finished
+	bool Flush(ImVec2& kept) {
+		if (!HasSleeve)
+			return false;
+		return Keep(Last, kept);
+	}
+	bool Keep(ImVec2 p, ImVec2& kept) {
+		Anchor = p;
+		HasAnchor = true;
+		HasSleeve = false;
+		Farthest = 0.0f;
+		Kept++;
+		kept = p;
+		return true;
+	}
+	// narrows the sleeve by p, false if p is outside of it
+	bool Fits(ImVec2 p) {
+		const float dx = p.x - Anchor.x;
+		const float dy = p.y - Anchor.y;
+		const float d = sqrtf(dx * dx + dy * dy);
+		if (d + Tolerance < Farthest)
+			return false;
+		Farthest = d > Farthest ? d : Farthest;
+		if (d <= Tolerance && !HasSleeve)
+			return true; // every direction passes close enough
+		const float width = d > Tolerance ? asinf(Tolerance / d) : 0.0f;
+		if (!HasSleeve) {
+			Direction = atan2f(dy, dx);
+			Low = -width;
+			High = width;
+			HasSleeve = true;
+			return true;
+		}
+		float angle = atan2f(dy, dx) - Direction;
+		if (angle > static_cast<float>(PI))
+			angle -= static_cast<float>(TWO_PI);
+		else if (angle < -static_cast<float>(PI))
+			angle += static_cast<float>(TWO_PI);
+		if (angle < Low || angle > High)
+			return false; // p itself, as the end of the line, has to be within the sleeve as well
+		if (d <= Tolerance)
+			return true;
+		Low = angle - width > Low ? angle - width : Low;
+		High = angle + width < High ? angle + width : High;
+		return true;
+	}
 };
 
 struct Complex
@@ -525,6 +864,8 @@ struct Complex
 	double re = 0.0f;
 	double im = 0.0f;
 
+	Complex() {}
+
 	Complex(double re, double im)
 	{
 		this->re = re;
@@ -560,36 +901,52 @@ struct greater_than_key
 	}
 };
 
-struct Wavelet {
-	ImVec2 tail = {};
-	ImVec2 tip = {};
-	ImVec2 rotation = {};;
-	ImVec2 pog = {};;
-	ImVec2 min = {};;
-	ImVec2 max = {};;
-	float radius = 0.0f;
-	float t = 0.0f;;
-	float rotFactor = 0.0f;
+// per wavelet data that is only needed for drawing and demodulation
+struct WaveletAttributes {
+	ImVec2 pog = {};
+	ImVec2 min = {};
+	ImVec2 max = {};
 	ImU32 color = 0;
-	float thikness = 0.0f;;
-	float index = 0.0f;;
+	float thickness = 0.0f;
 	int numCoords = 0;
 	float totX = 0;
 	float totY = 0;
-	bool isClockwise = true; 
 };
 
+// the wavelets are kept as a structure of arrays, one entry per wavelet in every array.
+// the hot arrays are read every frame in order (rotation, then the running sum of the tips),
+// the attributes are only touched when a wavelet is drawn
 class WaveletGenerator {
 private:
-	std::vector<Wavelet *> waveletQueue;
+	std::vector<float> indices;     // frequency of the wavelet
+	std::vector<float> radii;
+	std::vector<float> signs;       // 1 for clockwise, -1 mirrors the rotation
+	std::vector<ImVec2> rotations;  // radius vector at the current time
+	std::vector<ImVec2> tips;       // sum of the rotations up to and including the wavelet, the tail is the previous tip
+	std::vector<Complex> phasors;   // e^(i * index * t), advanced by the rotor in rotor mode
+	std::vector<Complex> rotors;    // e^(i * index * dt)
+	std::vector<WaveletAttributes> attributes;
+	std::vector<ImVec2> synthesis;  // final tips of the complete series at t = 2pi * j / size, empty if not synthesized
 	float normalizer;
 	float radius;
-	void Rotate(bool useSine, int i, float t);
+	void Rotate(int i, float t);
+	void Place(int i);
+	ImVec2 GetTail(int i);
+	void Draw(ImDrawList* draw_list, int index, ImVec2 origin, bool drawCircles, bool drawEdges);
+	void Append(float index, float radius, bool isClockwise, ImU32 color, float thickness);
+	void AdvanceRotors(float t);
 	ImVec2 finalTip;
 	bool useAlternateSeries;
 	float range;
 	float maxRange;
 	bool pauseDemodulator;
+	bool useRotors;
+	bool rotorsSynced;
+	float rotorTime;
+	float rotorStep;
+	int rotorSteps;
+	SinCos::Tier sincosTier; // of the batch in DrawWavelets, the single wavelets are measured and stay exact
+	int culled; // wavelets below LOD_MIN_RADIUS in the last DrawWavelets
 
 public:
 	WaveletGenerator(float radius);
@@ -602,17 +959,108 @@ public:
 	void DrawWavelets(ImDrawList* draw_list, float t, ImVec2 origin, bool drawCircles, bool drawEdges);
 	void DrawTraceLine(ImDrawList* draw_list, ImVec2 origin, bool drawEdges, float length = 2000.0f, ImU32 color = IM_COL32(200, 200, 200, 50), float thickness = 0.5f);
 	int GetSize();
+	int GetCulled();
 	float GetNormalizer();
 	void SetRadius(float radius);
+	float GetRadius(double index);
+	void Truncate(int count);
 	void AddWavelet(int index, ImU32 color = IM_COL32(250, 250, 220, 255), float thickness = 2.0f);
-	void AddWavelet(bool useSine, float frequency, float magnitude, ImU32 color = IM_COL32(250, 250, 220, 255), float thickness = 2.0f);
+	void AddWavelets(const uint64_t* sequence, int count, ImU32 color = IM_COL32(250, 250, 220, 255), float thickness = 2.0f);
+	void Reserve(int count);
+	void Synthesize(int first, int step, int count, int period);
+	void AddWavelet(bool isClockwise, float frequency, float magnitude, ImU32 color = IM_COL32(250, 250, 220, 255), float thickness = 2.0f);
 	void Clear();
 	void EnableAlternateSeries(bool enable);
+	void EnableRotors(bool enable);
+	void SetSinCosTier(SinCos::Tier tier);
 	ImVec2 GetPog();
 	float GetFrequency();
 	bool Pause();
 };
 
+// the complete spectra of one captured path, shared by all spectra selected from it
+struct SpectrumSource
+{
+	std::vector<WaveletStruct> Xdft;
+	std::vector<WaveletStruct> Ydft;
+	std::vector<WaveletStruct> Cdft;
+	size_t numSamples = 0;
+	unsigned int revision = 0; // of the captured path
+};
+
+// result of one recomputation of the spectra, never changed once published
+struct Spectrum
+{
+	std::shared_ptr<const SpectrumSource> source;
+	std::vector<WaveletStruct> Xdft;
+	std::vector<WaveletStruct> Ydft;
+	std::vector<WaveletStruct> Cdft;
+	size_t numSamples = 0; // length of the path, the coefficients may be a selection only
+	double rmsErrorXY = 0.0; // reconstruction error of the kept coefficients, in path units
+	double rmsErrorC = 0.0;
+	double energyKeptXY = 1.0; // fraction of the ac energy of the path that is kept
+	double energyKeptC = 1.0;
+	bool cappedXY = false; // the energy or error bound needs more than MAX_NODES coefficients, it is not met
+	bool cappedC = false;
+	std::vector<ImVec2> pathXY; // one period of the path traced by the kept coefficients, numSamples points
+	std::vector<ImVec2> pathC;
+	unsigned int generation = 0;
+};
+
+// recomputes the spectra on a background thread so the ui keeps running while a slider is dragged
+// Request never blocks: a job not yet started is replaced by the newer one,
+// a running job is asked to stop via IsSuperseded and its result is dropped.
+// the canvas draws the last published snapshot (Get) until the newest one is done
+class SpectrumWorker
+{
+private:
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable wakeup;
+	std::function<void(Spectrum&)> job;
+	unsigned int jobGeneration;
+	std::atomic<unsigned int> requested;
+	std::atomic<unsigned int> published;
+	bool quit;
+	std::shared_ptr<const Spectrum> current;
+
+	void Work();
+
+public:
+	SpectrumWorker();
+	~SpectrumWorker();
+
+	void Request(std::function<void(Spectrum&)> job);
+	bool IsSuperseded(unsigned int generation) const;
+	bool IsBusy() const;
+	std::shared_ptr<const Spectrum> Get() const;
+};
+
+// evaluates the curve of the live transform on a thread of its own, CURVE_SAMPLE_RATE samples per second
+// whatever the frame rate is. the samples (over -time, like the plots) reach the ui through lock-free rings,
+// a late wakeup produces the samples that are due at once
+class CurveWorker
+{
+private:
+	std::thread thread;
+	std::atomic<bool> running;
+	std::atomic<int> curve;
+	std::atomic<float> step; // time of the curve per sample
+	double time;
+
+	void Work();
+
+public:
+	SpscScrollingBuffer samples[2]; // the derivative (x) and the curve (y)
+
+	CurveWorker();
+	~CurveWorker();
+
+	void Start(int curve, float step, double time);
+	void Stop();
+	void Set(int curve, float step);
+	bool IsRunning() const;
+};
 
 class fourier
 {
@@ -621,30 +1069,38 @@ private:
 	static ExampleAppLog log;
 	static WaveletGenerator waveletGenerator;
 	static ScrollingBuffer tracer;
+	static PolylineSimplifier traceSimplifier;
+	static PolylineSimplifier captureSimplifier;
 	static ScrollingBuffer dataAnalog[3];
 	static ScrollingBuffer dataModulated;
 	static ScrollingBuffer demodulator[NUM_DEMODULATOR_GRAPHS];
 	static ScrollingBuffer result;
 	static std::vector<float> Xaxis;
 	static std::vector<float> Yaxis;
-	static std::vector<WaveletStruct>Xdft;
-	static std::vector<WaveletStruct>Ydft;
-	static std::vector<WaveletStruct>Cdft;
 	static ImVector<ImVec2> points;
 
 	static const char* strategies[];
 	static const char* curves[];
 	static const char* concepts[];
+	static const char* selections[];
+	static const char* sincosTiers[];
 	
 	int strategy_current;
 	int curve_current;
 	int concept_current;
+	int selection_current;
+	int sincos_current; // tier of the trigonometry that is only drawn
+	float energyFraction;
+	float rmsError;
 	bool isDemoWindow;
 	bool isPlots;
 	bool isDockspace;
 	bool isConsole;
 	bool isLog;
 	bool isAlternateSeries;
+	bool isRotorMode;
+	bool isSynthesisMode;
+	int numHarmonics;
 	float time;
 	double timePlot;
 	float timeChangeRate;
@@ -660,9 +1116,20 @@ private:
 	bool showCircles;
 	struct ImVec4 circle_color;
 	bool showEdges;
+	bool showTracePoints;
+	int traceBudget; // vertices of the trace per frame
+	float simplifyTolerance; // in pixels, of the trace and the captured path
+	SpectrumWorker spectrumWorker;
+	unsigned int spectrumGeneration;
+	CurveWorker curveWorker;
+	bool isCurveWorker; // the live transform samples its curve on the worker
+	int culledEpicycles; // coefficients below LOD_MIN_RADIUS in the last frame
 
 	void Setup();
+	void RequestSpectrum();
+	void ResizeWavelets();
 	void SetupMulitpleWavelets();
+	void SetupSynthesizedWavelets();
 	void SetupSingleWavelet();
 	void DrawCanvas();
 	void DrawProperties();
@@ -676,6 +1143,8 @@ private:
 	void DrawPlotsEpiCyclesScrolling(bool& p_open);
 	void DrawBackground(ImDrawList* draw_list, ImVec2 offset);
 	void Clear();
+	void AddTracePoint(ImVec2 p);
+	void EraseTrace();
 
 
 			
@@ -685,7 +1154,8 @@ public:
 	void Init();
 	std::vector<WaveletStruct> DFT(const std::vector<float> curve, int max_freq);
 	std::vector<WaveletStruct> DFT(const std::vector<Complex> curve, int max_freq);
-	ImVec2 DrawEpiCycles(float x, float y, double rotation, std::vector<WaveletStruct>& fourier, double time);
+	void DFT(const std::vector<float>& xcurve, const std::vector<float>& ycurve, int max_freq, std::vector<WaveletStruct>& xres, std::vector<WaveletStruct>& yres);
+	ImVec2 DrawEpiCycles(float x, float y, double rotation, const std::vector<WaveletStruct>& fourier, double time);
 
 };
 
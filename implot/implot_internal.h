@@ -1094,13 +1094,14 @@ struct ImPlotNextItemData {
     bool         HasHidden;
     bool         Hidden;
     ImPlotCond   HiddenCond;
+    bool         MonotonicX;
     ImPlotNextItemData() { Reset(); }
     void Reset() {
         for (int i = 0; i < 5; ++i)
             Colors[i] = IMPLOT_AUTO_COL;
         LineWeight    = MarkerSize = MarkerWeight = FillAlpha = ErrorBarSize = ErrorBarWeight = DigitalBitHeight = DigitalBitGap = IMPLOT_AUTO;
         Marker        = IMPLOT_AUTO;
-        HasHidden     = Hidden = false;
+        HasHidden     = Hidden = MonotonicX = false;
     }
 };
 
@@ -144,6 +144,11 @@ void SetNextErrorBarStyle(const ImVec4& col, float size, float weight) {
     gp.NextItemData.ErrorBarWeight             = weight;
 }
 
+void SetNextLineMonotonicX() {
+    ImPlotContext& gp = *GImPlot;
+    gp.NextItemData.MonotonicX = true;
+}
+
 ImVec4 GetLastItemColor() {
     ImPlotContext& gp = *GImPlot;
     if (gp.PreviousItem)
@@ -371,6 +376,18 @@ struct GetterXs {
     const int Stride;
 };
 
+/// Interprets the points [First, First + Count) of another getter as its own
+template <typename TGetter>
+struct GetterSlice {
+    GetterSlice(const TGetter& getter, int first, int count) : Getter(getter), First(first), Count(count) { }
+    template <typename I> IMPLOT_INLINE ImPlotPoint operator()(I idx) const {
+        return Getter(First + idx);
+    }
+    const TGetter& Getter;
+    const int First;
+    const int Count;
+};
+
 /// Interprets a user's function pointer as ImPlotPoints
 struct GetterFuncPtr {
     GetterFuncPtr(ImPlotPoint (*getter)(void* data, int idx), void* data, int count) :
@@ -924,6 +941,59 @@ IMPLOT_INLINE void RenderMarkers(Getter getter, Transformer transformer, ImDrawL
 // PLOT LINE
 //-----------------------------------------------------------------------------
 
+// Finds the slice [first, first + count) of points with monotonic x that is visible on the current x axis,
+// plus one point to either side so the segments leaving the plot are kept. O(log(N))
+template <typename Getter>
+IMPLOT_INLINE void GetVisibleSliceX(const Getter& getter, int& first, int& count) {
+    ImPlotPlot& plot = *GetCurrentPlot();
+    const ImPlotRange& range = plot.Axes[plot.CurrentX].Range;
+    // in keys that increase with the index
+    const double dir = getter(getter.Count - 1).x >= getter(0).x ? 1 : -1;
+    const double lo  = dir > 0 ? range.Min : -range.Max;
+    const double hi  = dir > 0 ? range.Max : -range.Min;
+    int l = 0, r = getter.Count;
+    while (l < r) { // first point at or past lo
+        const int m = l + (r - l) / 2;
+        if (dir * getter(m).x < lo) l = m + 1; else r = m;
+    }
+    const int begin = l;
+    r = getter.Count;
+    while (l < r) { // first point past hi
+        const int m = l + (r - l) / 2;
+        if (dir * getter(m).x <= hi) l = m + 1; else r = m;
+    }
+    first = ImMax(begin - 1, 0);
+    count = ImMin(l + 1, getter.Count) - first;
+}
+
+template <typename Getter>
+IMPLOT_INLINE void RenderLineItem(const Getter& getter, const ImPlotNextItemData& s) {
+    ImDrawList& DrawList = *GetPlotDrawList();
+    if (getter.Count > 1 && s.RenderLine) {
+        const ImU32 col_line    = ImGui::GetColorU32(s.Colors[ImPlotCol_Line]);
+        switch (GetCurrentScale()) {
+            case ImPlotScale_LinLin: RenderLineStrip(getter, TransformerLinLin(), DrawList, s.LineWeight, col_line); break;
+            case ImPlotScale_LogLin: RenderLineStrip(getter, TransformerLogLin(), DrawList, s.LineWeight, col_line); break;
+            case ImPlotScale_LinLog: RenderLineStrip(getter, TransformerLinLog(), DrawList, s.LineWeight, col_line); break;
+            case ImPlotScale_LogLog: RenderLineStrip(getter, TransformerLogLog(), DrawList, s.LineWeight, col_line); break;
+        }
+    }
+    // render markers
+    if (s.Marker != ImPlotMarker_None) {
+        // uncomment lines below to render markers over plot rect border
+        // PopPlotClipRect();
+        // PushPlotClipRect(s.MarkerSize);
+        const ImU32 col_line = ImGui::GetColorU32(s.Colors[ImPlotCol_MarkerOutline]);
+        const ImU32 col_fill = ImGui::GetColorU32(s.Colors[ImPlotCol_MarkerFill]);
+        switch (GetCurrentScale()) {
+            case ImPlotScale_LinLin: RenderMarkers(getter, TransformerLinLin(), DrawList, s.Marker, s.MarkerSize, s.RenderMarkerLine, col_line, s.MarkerWeight, s.RenderMarkerFill, col_fill); break;
+            case ImPlotScale_LogLin: RenderMarkers(getter, TransformerLogLin(), DrawList, s.Marker, s.MarkerSize, s.RenderMarkerLine, col_line, s.MarkerWeight, s.RenderMarkerFill, col_fill); break;
+            case ImPlotScale_LinLog: RenderMarkers(getter, TransformerLinLog(), DrawList, s.Marker, s.MarkerSize, s.RenderMarkerLine, col_line, s.MarkerWeight, s.RenderMarkerFill, col_fill); break;
+            case ImPlotScale_LogLog: RenderMarkers(getter, TransformerLogLog(), DrawList, s.Marker, s.MarkerSize, s.RenderMarkerLine, col_line, s.MarkerWeight, s.RenderMarkerFill, col_fill); break;
+        }
+    }
+}
+
 template <typename Getter>
 IMPLOT_INLINE void PlotLineEx(const char* label_id, const Getter& getter) {
     if (BeginItem(label_id, ImPlotCol_Line)) {
@@ -934,29 +1004,13 @@ IMPLOT_INLINE void PlotLineEx(const char* label_id, const Getter& getter) {
             }
         }
         const ImPlotNextItemData& s = GetItemData();
-        ImDrawList& DrawList = *GetPlotDrawList();
-        if (getter.Count > 1 && s.RenderLine) {
-            const ImU32 col_line    = ImGui::GetColorU32(s.Colors[ImPlotCol_Line]);
-            switch (GetCurrentScale()) {
-                case ImPlotScale_LinLin: RenderLineStrip(getter, TransformerLinLin(), DrawList, s.LineWeight, col_line); break;
-                case ImPlotScale_LogLin: RenderLineStrip(getter, TransformerLogLin(), DrawList, s.LineWeight, col_line); break;
-                case ImPlotScale_LinLog: RenderLineStrip(getter, TransformerLinLog(), DrawList, s.LineWeight, col_line); break;
-                case ImPlotScale_LogLog: RenderLineStrip(getter, TransformerLogLog(), DrawList, s.LineWeight, col_line); break;
-            }
+        if (s.MonotonicX && getter.Count > 2) {
+            int first, count;
+            GetVisibleSliceX(getter, first, count);
+            RenderLineItem(GetterSlice<Getter>(getter, first, count), s);
         }
-        // render markers
-        if (s.Marker != ImPlotMarker_None) {
-            // uncomment lines below to render markers over plot rect border
-            // PopPlotClipRect();
-            // PushPlotClipRect(s.MarkerSize);
-            const ImU32 col_line = ImGui::GetColorU32(s.Colors[ImPlotCol_MarkerOutline]);
-            const ImU32 col_fill = ImGui::GetColorU32(s.Colors[ImPlotCol_MarkerFill]);
-            switch (GetCurrentScale()) {
-                case ImPlotScale_LinLin: RenderMarkers(getter, TransformerLinLin(), DrawList, s.Marker, s.MarkerSize, s.RenderMarkerLine, col_line, s.MarkerWeight, s.RenderMarkerFill, col_fill); break;
-                case ImPlotScale_LogLin: RenderMarkers(getter, TransformerLogLin(), DrawList, s.Marker, s.MarkerSize, s.RenderMarkerLine, col_line, s.MarkerWeight, s.RenderMarkerFill, col_fill); break;
-                case ImPlotScale_LinLog: RenderMarkers(getter, TransformerLinLog(), DrawList, s.Marker, s.MarkerSize, s.RenderMarkerLine, col_line, s.MarkerWeight, s.RenderMarkerFill, col_fill); break;
-                case ImPlotScale_LogLog: RenderMarkers(getter, TransformerLogLog(), DrawList, s.Marker, s.MarkerSize, s.RenderMarkerLine, col_line, s.MarkerWeight, s.RenderMarkerFill, col_fill); break;
-            }
+        else {
+            RenderLineItem(getter, s);
         }
         EndItem();
     }
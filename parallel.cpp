@@ -0,0 +1,165 @@
+#include "parallel.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct TaskGroup
+{
+	std::atomic<size_t> pending{ 0 };
+};
+
+struct Task
+{
+	std::function<void()> run;
+	TaskGroup* group;
+};
+
+class ThreadPool
+{
+private:
+	std::mutex mutex;
+	std::condition_variable wakeup;
+	std::deque<Task> queue;
+	std::vector<std::thread> workers;
+	bool quit = false;
+
+	void Work()
+	{
+		for (;;)
+		{
+			Task task;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wakeup.wait(lock, [this] { return quit || !queue.empty(); });
+				if (quit && queue.empty())
+					return;
+				task = std::move(queue.front());
+				queue.pop_front();
+			}
+			task.run();
+			task.group->pending--;
+		}
+	}
+
+	// runs one queued task of the group on the calling thread, false if none is left
+	bool RunOne(TaskGroup& group)
+	{
+		Task task;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			auto it = queue.begin();
+			while (it != queue.end() && it->group != &group)
+				++it;
+			if (it == queue.end())
+				return false;
+			task = std::move(*it);
+			queue.erase(it);
+		}
+		task.run();
+		group.pending--;
+		return true;
+	}
+
+public:
+	ThreadPool()
+	{
+		unsigned int cores = std::thread::hardware_concurrency();
+		for (unsigned int i = 1; i < cores; i++)
+			workers.emplace_back(&ThreadPool::Work, this);
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quit = true;
+		}
+		wakeup.notify_all();
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	unsigned int GetThreadCount() const
+	{
+		return static_cast<unsigned int>(workers.size()) + 1;
+	}
+
+	void Submit(TaskGroup& group, std::function<void()> run)
+	{
+		group.pending++;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			queue.push_back({ std::move(run), &group });
+		}
+		wakeup.notify_one();
+	}
+
+	void Wait(TaskGroup& group)
+	{
+		// only tasks of the own group are helped with, a foreign task could reuse
+		// per thread state (eg. fft scratch buffers) which is still in use further up the stack
+		while (group.pending > 0)
+		{
+			if (!RunOne(group))
+				std::this_thread::yield();
+		}
+	}
+};
+
+static ThreadPool& GetPool()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+unsigned int Parallel::GetThreadCount()
+{
+	return GetPool().GetThreadCount();
+}
+
+void Parallel::Invoke(const std::vector<std::function<void()>>& tasks)
+{
+	if (tasks.empty())
+		return;
+
+	ThreadPool& pool = GetPool();
+	TaskGroup group;
+	for (size_t i = 1; i < tasks.size(); i++)
+		pool.Submit(group, tasks[i]);
+	tasks[0]();
+	pool.Wait(group);
+}
+
+void Parallel::For(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body)
+{
+	if (end <= begin)
+		return;
+
+	ThreadPool& pool = GetPool();
+	const size_t count = end - begin;
+	if (grain < 1)
+		grain = 1;
+
+	// a few ranges per thread so uneven ranges even out
+	size_t ranges = count / grain;
+	const size_t maxRanges = 4 * static_cast<size_t>(pool.GetThreadCount());
+	if (ranges > maxRanges)
+		ranges = maxRanges;
+	if (ranges <= 1 || pool.GetThreadCount() == 1)
+	{
+		body(begin, end);
+		return;
+	}
+
+	const size_t size = (count + ranges - 1) / ranges;
+	TaskGroup group;
+	for (size_t first = begin + size; first < end; first += size)
+	{
+		const size_t last = first + size < end ? first + size : end;
+		pool.Submit(group, [&body, first, last] { body(first, last); });
+	}
+	body(begin, begin + size < end ? begin + size : end);
+	pool.Wait(group);
+}
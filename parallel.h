@@ -0,0 +1,19 @@
+#pragma once
+#include <functional>
+#include <vector>
+
+// small persistent thread pool for the heavy lifting of Setup (transforms, sorting)
+// the workers are started on first use, one per core minus the calling thread.
+// a thread waiting for its tasks runs the not yet started ones itself (but only its own),
+// so parallel sections can be nested, eg. a task of Invoke may call For
+class Parallel
+{
+public:
+	static unsigned int GetThreadCount(); // workers + the calling thread
+
+	// runs all tasks and returns when every one of them is done
+	static void Invoke(const std::vector<std::function<void()>>& tasks);
+
+	// splits [begin, end) into ranges of at least grain items and calls body(first, last) for each of them
+	static void For(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body);
+};
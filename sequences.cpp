@@ -0,0 +1,250 @@
+#include "sequences.h"
+
+// every table is taken from one sieve that reaches the 1000th balanced prime (273629),
+// the reversed digits of the emirps (at most 99999) are covered by it as well
+#define SEQUENCE_SIEVE_LIMIT 274000
+#define SEQUENCE_SIEVE_WORDS ((SEQUENCE_SIEVE_LIMIT + 63) / 64)
+#define SEQUENCE_SIEVE_BLOCK 65536 // compilers limit the iterations of a single constant evaluated loop
+#define SEQUENCE_FIBONACCI_LENGTH 92
+
+struct SequenceTable
+{
+	uint64_t values[SEQUENCE_LENGTH];
+	int size;
+};
+
+struct PrimeTable
+{
+	uint64_t values[2 * SEQUENCE_LENGTH];
+	int size;
+};
+
+// one bit per number, set for composites
+struct SieveTable
+{
+	uint64_t composite[SEQUENCE_SIEVE_WORDS];
+};
+
+static constexpr SieveTable Sieve()
+{
+	SieveTable sieve = {};
+	sieve.composite[0] = 3; // 0 and 1
+	for (uint64_t n = 2; n * n < SEQUENCE_SIEVE_LIMIT; n++)
+	{
+		if (sieve.composite[n / 64] & (1ull << (n % 64)))
+			continue;
+		for (uint64_t m = n * n; m < SEQUENCE_SIEVE_LIMIT; m += n)
+			sieve.composite[m / 64] |= 1ull << (m % 64);
+	}
+	return sieve;
+}
+
+static constexpr SieveTable sieve = Sieve();
+
+static constexpr bool IsPrime(uint64_t n)
+{
+	return n < SEQUENCE_SIEVE_LIMIT && !(sieve.composite[n / 64] & (1ull << (n % 64)));
+}
+
+static constexpr uint64_t Reverse(uint64_t n)
+{
+	uint64_t reversed = 0;
+	for (; n > 0; n /= 10)
+		reversed = reversed * 10 + n % 10;
+	return reversed;
+}
+
+// the first 2 * SEQUENCE_LENGTH primes, so both halves of the alternate primes are complete
+static constexpr PrimeTable MakePrimes()
+{
+	PrimeTable table = {};
+	for (uint64_t block = 0; block < SEQUENCE_SIEVE_LIMIT && table.size < 2 * SEQUENCE_LENGTH; block += SEQUENCE_SIEVE_BLOCK)
+	{
+		for (uint64_t n = block; n < block + SEQUENCE_SIEVE_BLOCK && table.size < 2 * SEQUENCE_LENGTH; n++)
+		{
+			if (IsPrime(n))
+				table.values[table.size++] = n;
+		}
+	}
+	return table;
+}
+
+static constexpr PrimeTable primes = MakePrimes();
+
+// every other prime, starting at primes[first]
+static constexpr SequenceTable MakeAlternatePrimes(int first)
+{
+	SequenceTable table = {};
+	for (int i = first; i < primes.size && table.size < SEQUENCE_LENGTH; i += 2)
+		table.values[table.size++] = primes.values[i];
+	return table;
+}
+
+static constexpr SequenceTable MakeBalancedPrimes()
+{
+	SequenceTable table = {};
+	uint64_t previous = 2;
+	uint64_t current = 3;
+	for (uint64_t block = 0; block < SEQUENCE_SIEVE_LIMIT && table.size < SEQUENCE_LENGTH; block += SEQUENCE_SIEVE_BLOCK)
+	{
+		for (uint64_t next = block < 5 ? 5 : block + 1; next < block + SEQUENCE_SIEVE_BLOCK && next < SEQUENCE_SIEVE_LIMIT && table.size < SEQUENCE_LENGTH; next += 2)
+		{
+			if (!IsPrime(next))
+				continue;
+			if (2 * current == previous + next)
+				table.values[table.size++] = current;
+			previous = current;
+			current = next;
+		}
+	}
+	return table;
+}
+
+static constexpr SequenceTable MakeEmirps()
+{
+	SequenceTable table = {};
+	for (uint64_t block = 0; block < SEQUENCE_SIEVE_LIMIT && table.size < SEQUENCE_LENGTH; block += SEQUENCE_SIEVE_BLOCK)
+	{
+		for (uint64_t n = block < 11 ? 11 : block + 1; n < block + SEQUENCE_SIEVE_BLOCK && table.size < SEQUENCE_LENGTH; n += 2)
+		{
+			const uint64_t reversed = Reverse(n);
+			if (reversed != n && IsPrime(n) && IsPrime(reversed))
+				table.values[table.size++] = n;
+		}
+	}
+	return table;
+}
+
+static constexpr SequenceTable MakeFibonacci()
+{
+	SequenceTable table = {};
+	uint64_t previous = 1;
+	uint64_t current = 1;
+	while (table.size < SEQUENCE_FIBONACCI_LENGTH)
+	{
+		const uint64_t next = previous + current;
+		table.values[table.size++] = current;
+		previous = current;
+		current = next;
+	}
+	return table;
+}
+
+static constexpr SequenceTable unevenPrimes = MakeAlternatePrimes(1);
+static constexpr SequenceTable evenPrimes = MakeAlternatePrimes(0);
+static constexpr SequenceTable balancedPrimes = MakeBalancedPrimes();
+static constexpr SequenceTable emirps = MakeEmirps();
+static constexpr SequenceTable fibonacci = MakeFibonacci();
+
+// whether p divides an euler number needs E(2k) mod p for every k < p / 2, far too much work
+// for the compiler, so these are precomputed: the first SEQUENCE_LENGTH primes p for which
+// one of E(2), E(4) ... E(p - 3) is a multiple of p (1 / cosh(x) as a power series mod p)
+static const uint64_t eulerIrregularPrimes[SEQUENCE_LENGTH] =
+{
+	19, 31, 43, 47, 61, 67, 71, 79, 101, 137, 139, 149,
+	193, 223, 241, 251, 263, 277, 307, 311, 349, 353, 359, 373,
+	379, 419, 433, 461, 463, 491, 509, 541, 563, 571, 577, 587,
+	619, 677, 691, 709, 739, 751, 761, 769, 773, 811, 821, 877,
+	887, 907, 929, 941, 967, 971, 983, 1013, 1019, 1031, 1039, 1049,
+	1051, 1069, 1151, 1163, 1187, 1223, 1229, 1231, 1277, 1279, 1283, 1291,
+	1307, 1319, 1361, 1381, 1399, 1409, 1423, 1427, 1429, 1439, 1447, 1453,
+	1523, 1531, 1559, 1583, 1601, 1621, 1637, 1663, 1693, 1697, 1723, 1733,
+	1759, 1787, 1801, 1831, 1867, 1873, 1877, 1879, 1889, 1901, 1907, 1931,
+	1933, 1951, 1987, 1993, 1997, 2011, 2039, 2063, 2069, 2081, 2083, 2099,
+	2129, 2131, 2137, 2141, 2143, 2161, 2179, 2203, 2213, 2221, 2239, 2293,
+	2341, 2377, 2411, 2417, 2459, 2473, 2477, 2531, 2543, 2579, 2591, 2609,
+	2617, 2633, 2659, 2671, 2677, 2687, 2699, 2711, 2729, 2731, 2749, 2797,
+	2803, 2819, 2843, 2879, 2897, 2917, 2957, 2963, 2971, 2999, 3001, 3061,
+	3067, 3079, 3089, 3119, 3121, 3137, 3163, 3167, 3169, 3187, 3217, 3257,
+	3301, 3313, 3331, 3343, 3449, 3467, 3491, 3517, 3539, 3541, 3547, 3571,
+	3581, 3623, 3631, 3671, 3673, 3677, 3701, 3727, 3733, 3761, 3793, 3797,
+	3821, 3833, 3847, 3851, 3853, 3911, 3917, 3923, 3989, 4003, 4007, 4021,
+	4051, 4057, 4093, 4099, 4129, 4133, 4153, 4241, 4259, 4271, 4283, 4289,
+	4337, 4339, 4349, 4357, 4373, 4391, 4397, 4421, 4463, 4481, 4493, 4523,
+	4549, 4591, 4603, 4643, 4657, 4673, 4679, 4691, 4703, 4721, 4729, 4733,
+	4789, 4799, 4813, 4817, 4861, 4871, 4933, 4937, 4943, 5009, 5101, 5107,
+	5113, 5147, 5153, 5209, 5227, 5233, 5279, 5303, 5351, 5393, 5399, 5413,
+	5521, 5527, 5531, 5557, 5563, 5569, 5591, 5623, 5639, 5641, 5659, 5689,
+	5711, 5783, 5801, 5807, 5813, 5827, 5843, 5849, 5857, 5867, 5879, 5881,
+	6011, 6037, 6043, 6047, 6053, 6089, 6121, 6131, 6211, 6229, 6247, 6263,
+	6269, 6271, 6301, 6329, 6337, 6359, 6379, 6397, 6421, 6427, 6449, 6473,
+	6571, 6577, 6607, 6619, 6653, 6659, 6691, 6709, 6719, 6737, 6779, 6791,
+	6793, 6803, 6833, 6863, 6869, 6899, 6947, 6971, 6977, 6991, 6997, 7019,
+	7039, 7043, 7069, 7079, 7103, 7121, 7129, 7151, 7177, 7193, 7207, 7213,
+	7219, 7229, 7243, 7297, 7307, 7309, 7321, 7331, 7351, 7393, 7411, 7417,
+	7433, 7481, 7487, 7489, 7507, 7517, 7529, 7541, 7559, 7577, 7589, 7591,
+	7603, 7607, 7639, 7669, 7681, 7723, 7727, 7741, 7753, 7757, 7789, 7853,
+	7907, 7937, 7949, 7993, 8039, 8059, 8081, 8089, 8101, 8111, 8117, 8123,
+	8171, 8219, 8221, 8231, 8233, 8237, 8291, 8311, 8329, 8377, 8387, 8389,
+	8423, 8429, 8431, 8447, 8501, 8527, 8573, 8609, 8627, 8629, 8647, 8663,
+	8669, 8681, 8689, 8693, 8713, 8719, 8737, 8761, 8803, 8821, 8831, 8837,
+	8839, 8863, 8893, 8923, 8929, 9001, 9011, 9049, 9067, 9091, 9127, 9133,
+	9137, 9181, 9187, 9257, 9277, 9323, 9337, 9341, 9371, 9377, 9391, 9397,
+	9403, 9413, 9473, 9491, 9511, 9539, 9547, 9587, 9601, 9613, 9619, 9623,
+	9629, 9631, 9643, 9677, 9689, 9733, 9739, 9767, 9791, 9811, 9817, 9883,
+	9887, 9907, 9967, 10007, 10037, 10061, 10091, 10093, 10141, 10169, 10181, 10193,
+	10243, 10253, 10259, 10273, 10289, 10303, 10313, 10321, 10343, 10357, 10369, 10391,
+	10429, 10433, 10457, 10463, 10477, 10487, 10513, 10529, 10597, 10613, 10639, 10651,
+	10657, 10687, 10709, 10711, 10733, 10799, 10837, 10861, 10883, 10909, 10949, 10973,
+	10987, 10993, 11069, 11087, 11093, 11119, 11131, 11149, 11161, 11177, 11213, 11239,
+	11243, 11279, 11287, 11321, 11383, 11411, 11423, 11483, 11491, 11503, 11551, 11579,
+	11587, 11621, 11633, 11657, 11677, 11681, 11743, 11783, 11807, 11813, 11831, 11867,
+	11887, 11903, 11909, 11923, 11927, 11953, 11969, 11971, 11981, 12011, 12041, 12043,
+	12049, 12073, 12101, 12107, 12119, 12149, 12157, 12163, 12197, 12211, 12251, 12301,
+	12343, 12379, 12391, 12421, 12437, 12451, 12457, 12479, 12503, 12511, 12517, 12569,
+	12577, 12589, 12601, 12611, 12619, 12647, 12653, 12671, 12703, 12763, 12781, 12809,
+	12823, 12841, 12889, 12899, 12911, 12959, 12967, 12983, 13003, 13009, 13043, 13147,
+	13177, 13183, 13249, 13259, 13291, 13309, 13327, 13367, 13381, 13411, 13417, 13421,
+	13457, 13567, 13577, 13597, 13633, 13649, 13679, 13691, 13723, 13729, 13763, 13807,
+	13831, 13841, 13873, 13907, 13913, 13921, 13933, 13999, 14029, 14057, 14081, 14149,
+	14197, 14249, 14293, 14369, 14437, 14461, 14489, 14503, 14551, 14557, 14563, 14593,
+	14621, 14629, 14633, 14653, 14683, 14717, 14723, 14731, 14737, 14741, 14747, 14759,
+	14771, 14821, 14827, 14843, 14869, 14969, 14983, 15017, 15031, 15101, 15107, 15131,
+	15187, 15199, 15241, 15259, 15263, 15271, 15287, 15289, 15299, 15313, 15319, 15373,
+	15383, 15493, 15527, 15541, 15559, 15581, 15607, 15643, 15647, 15679, 15683, 15749,
+	15877, 15887, 15889, 15907, 15923, 15971, 15973, 16001, 16007, 16061, 16063, 16103,
+	16141, 16193, 16217, 16229, 16253, 16267, 16301, 16319, 16333, 16363, 16493, 16519,
+	16547, 16567, 16573, 16603, 16619, 16651, 16691, 16693, 16699, 16829, 16831, 16843,
+	16871, 16879, 16921, 16937, 16979, 16987, 17011, 17021, 17041, 17047, 17107, 17123,
+	17159, 17189, 17191, 17231, 17291, 17327, 17383, 17393, 17419, 17431, 17449, 17467,
+	17471, 17509, 17539, 17597, 17623, 17627, 17657, 17659, 17681, 17683, 17737, 17747,
+	17749, 17783, 17839, 17891, 17903, 17909, 17911, 17923, 17929, 17957, 17971, 17987,
+	18043, 18047, 18121, 18131, 18133, 18143, 18233, 18251, 18307, 18313, 18371, 18397,
+	18401, 18413, 18439, 18457, 18461, 18493, 18523, 18587, 18593, 18617, 18691, 18743,
+	18757, 18839, 18859, 18911, 18959, 18973, 19037, 19051, 19069, 19087, 19181, 19207,
+	19231, 19249, 19267, 19309, 19319, 19373, 19379, 19381, 19403, 19417, 19471, 19501,
+	19531, 19543, 19577, 19687, 19717, 19727, 19739, 19751, 19763, 19777, 19801, 19813,
+	19819, 19853, 19861, 19889, 19891, 19913, 19919, 19973, 19979, 19991, 19993, 20021,
+	20023, 20029, 20047, 20051, 20101, 20117, 20129, 20149, 20261, 20297, 20333, 20347,
+	20357, 20359, 20369, 20389, 20393, 20443, 20483, 20507, 20509, 20543, 20641, 20663,
+	20681, 20731, 20749, 20759, 20771, 20773, 20807, 20809, 20857, 20873, 20887, 20903,
+	20921, 20947, 20959, 21019, 21023, 21059, 21067, 21089, 21101, 21121, 21157, 21169,
+	21193, 21227, 21247, 21317, 21319, 21383, 21433, 21467, 21493, 21499, 21503, 21529,
+	21563, 21577, 21587, 21589, 21599, 21601, 21751, 21817, 21821, 21839, 21859, 21911,
+	21997, 22027, 22037, 22051, 22063, 22067, 22073, 22091, 22093, 22109, 22129, 22133,
+	22147, 22189, 22247, 22271, 22273, 22277, 22291, 22381, 22391, 22433, 22441, 22453,
+	22469, 22481, 22483, 22531, 22541, 22543, 22567, 22571, 22573, 22613, 22619, 22639,
+	22643, 22669, 22691, 22727,
+};
+
+static_assert(primes.size == 2 * SEQUENCE_LENGTH && balancedPrimes.size == SEQUENCE_LENGTH && emirps.size == SEQUENCE_LENGTH, "the sieve limit is too small");
+static_assert(fibonacci.values[SEQUENCE_FIBONACCI_LENGTH - 1] == 12200160415121876738ull, "F(93) is the last fibonacci number in 64 bits");
+
+const uint64_t* Sequences::Get(Kind kind)
+{
+	switch (kind)
+	{
+	case Primes: return primes.values;
+	case UnevenPrimes: return unevenPrimes.values;
+	case EvenPrimes: return evenPrimes.values;
+	case BalancedPrimes: return balancedPrimes.values;
+	case Emirps: return emirps.values;
+	case EulerIrregularPrimes: return eulerIrregularPrimes;
+	default: return fibonacci.values;
+	}
+}
+
+int Sequences::GetLength(Kind kind)
+{
+	return kind == Fibonacci ? fibonacci.size : SEQUENCE_LENGTH;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <stdint.h>
+
+// index sequences of the prime and fibonacci strategies of the fourier series.
+// the tables are built at compile time (see sequences.cpp) and hold the first
+// SEQUENCE_LENGTH values, the node slider of their strategies stops there;
+// fibonacci stops at F(93), the last one that fits into 64 bits
+#define SEQUENCE_LENGTH 1000
+
+class Sequences
+{
+public:
+	enum Kind
+	{
+		Primes,
+		UnevenPrimes,          // every other prime starting at 3
+		EvenPrimes,            // every other prime starting at 2
+		BalancedPrimes,        // the mean of their neighbouring primes
+		Emirps,                // primes whose reversed digits are a different prime
+		EulerIrregularPrimes,  // primes dividing one of the euler numbers E(2), E(4) ... E(p - 3)
+		Fibonacci,             // 1, 2, 3, 5, 8 ...
+	};
+
+	static const uint64_t* Get(Kind kind);
+	static int GetLength(Kind kind);
+};
@@ -0,0 +1,188 @@
+#include "sincos.h"
+#include "sincos_simd.h"
+#include "fft_kernels.h"
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+static const double SINCOS_TWO_PI = 6.283185307179586476925286766559;
+
+static const char* names[] = { "Exact", "Fast", "Table" };
+
+const float* GetSinTable()
+{
+	struct SinTable
+	{
+		float values[SINCOS_TABLE_SIZE + SINCOS_TABLE_SIZE / 4 + 1];
+		SinTable()
+		{
+			for (int i = 0; i < SINCOS_TABLE_SIZE + SINCOS_TABLE_SIZE / 4 + 1; i++)
+				values[i] = static_cast<float>(sin(SINCOS_TWO_PI * i / SINCOS_TABLE_SIZE));
+		}
+	};
+	static const SinTable table;
+	return table.values;
+}
+
+// the scalar forms do the same steps as the vector cores
+static void GetFast(double x, double& s, double& c)
+{
+	const double q = nearbyint(x * 0.63661977236758134308);
+	const float r = static_cast<float>((x - q * 1.5707963267948966) - q * 6.123233995736766e-17);
+	const float z = r * r;
+
+	const float ps = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * r + r;
+	const float pc = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+
+	switch (static_cast<long long>(q) & 3)
+	{
+	case 0: s = ps; c = pc; break;
+	case 1: s = pc; c = -ps; break;
+	case 2: s = -ps; c = -pc; break;
+	default: s = -pc; c = ps; break;
+	}
+}
+
+static void GetTable(double x, double& s, double& c)
+{
+	const float* table = GetSinTable();
+	const double u = x * (SINCOS_TABLE_SIZE / SINCOS_TWO_PI);
+	const double i = floor(u);
+	const float f = static_cast<float>(u - i);
+	const int index = static_cast<int>(static_cast<long long>(i) & (SINCOS_TABLE_SIZE - 1));
+
+	s = table[index] + f * (table[index + 1] - table[index]);
+	c = table[index + SINCOS_TABLE_SIZE / 4] + f * (table[index + SINCOS_TABLE_SIZE / 4 + 1] - table[index + SINCOS_TABLE_SIZE / 4]);
+}
+
+const char* SinCos::GetName(Tier tier)
+{
+	return names[tier];
+}
+
+void SinCos::Get(Tier tier, double x, double& s, double& c)
+{
+	switch (tier)
+	{
+	case Fast:
+		GetFast(x, s, c);
+		break;
+	case Table:
+		GetTable(x, s, c);
+		break;
+	default:
+		s = sin(x);
+		c = cos(x);
+		break;
+	}
+}
+
+double SinCos::Sin(Tier tier, double x)
+{
+	double s, c;
+	Get(tier, x, s, c);
+	return s;
+}
+
+double SinCos::Cos(Tier tier, double x)
+{
+	double s, c;
+	Get(tier, x, s, c);
+	return c;
+}
+
+static void BatchScalar(SinCos::Tier tier, const float* x, float t, float* s, float* c, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		double sd, cd;
+		SinCos::Get(tier, static_cast<double>(t) * x[i], sd, cd);
+		s[i] = static_cast<float>(sd);
+		c[i] = static_cast<float>(cd);
+	}
+}
+
+#ifdef SINCOS_X86
+
+SINCOS_TARGET("avx2,fma")
+static void BatchAVX2(SinCos::Tier tier, const float* x, float t, float* s, float* c, size_t count)
+{
+	const float* table = GetSinTable();
+	const __m256d time = _mm256_set1_pd(t);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m256 v = _mm256_loadu_ps(x + i);
+		const __m256d x0 = _mm256_mul_pd(time, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+		const __m256d x1 = _mm256_mul_pd(time, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+
+		__m256 vs, vc;
+		if (tier == SinCos::Table)
+			SinCosTableAVX2(x0, x1, table, vs, vc);
+		else
+			SinCosFastAVX2(x0, x1, vs, vc);
+		_mm256_storeu_ps(s + i, vs);
+		_mm256_storeu_ps(c + i, vc);
+	}
+
+	BatchScalar(tier, x + i, t, s + i, c + i, count - i);
+}
+
+#endif
+
+void SinCos::Batch(Tier tier, const float* x, float t, float* s, float* c, size_t count)
+{
+#ifdef SINCOS_X86
+	if (tier != Exact && FFTKernels::Get().level == FFTKernels::AVX2)
+	{
+		BatchAVX2(tier, x, t, s, c, count);
+		return;
+	}
+#endif
+	BatchScalar(tier, x, t, s, c, count);
+}
+
+// keeps the timed scalar loop from being optimized away
+static volatile double sink;
+
+SinCos::Accuracy SinCos::Measure(Tier tier)
+{
+	// angles t * i as the wavelets of a long fourier series see them
+	const size_t count = 1 << 16;
+	const float t = static_cast<float>(SINCOS_TWO_PI * 1e5 / count);
+	std::vector<float> x(count), s(count), c(count);
+	for (size_t i = 0; i < count; i++)
+		x[i] = static_cast<float>(i) - count / 2;
+
+	Accuracy accuracy = {};
+	double sum = 0.0;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < count; i++)
+	{
+		double sd, cd;
+		Get(tier, static_cast<double>(t) * x[i], sd, cd);
+		sum += sd + cd;
+	}
+	auto end = std::chrono::steady_clock::now();
+	accuracy.nsScalar = std::chrono::duration<double, std::nano>(end - start).count() / count;
+	sink = sum;
+
+	start = std::chrono::steady_clock::now();
+	Batch(tier, x.data(), t, s.data(), c.data(), count);
+	end = std::chrono::steady_clock::now();
+	accuracy.nsBatch = std::chrono::duration<double, std::nano>(end - start).count() / count;
+
+	double squares = 0.0;
+	for (size_t i = 0; i < count; i++)
+	{
+		const double angle = static_cast<double>(t) * x[i];
+		const double es = fabs(s[i] - sin(angle));
+		const double ec = fabs(c[i] - cos(angle));
+		accuracy.maxError = es > accuracy.maxError ? es : accuracy.maxError;
+		accuracy.maxError = ec > accuracy.maxError ? ec : accuracy.maxError;
+		squares += es * es + ec * ec;
+	}
+	accuracy.rmsError = sqrt(squares / (2.0 * count));
+	return accuracy;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <stddef.h>
+
+// sin and cos in three precision tiers, every call site picks the one it needs:
+// Exact is libm in double precision (transform setup, anything that is measured),
+// Fast is a float minimax polynomial after a double precision range reduction (~1e-7),
+// Table interpolates linearly between 256 samples of a period (~1e-4, for drawing only).
+// Batch evaluates 8 values at once with AVX2 if the fft kernels run at that level
+class SinCos
+{
+public:
+	enum Tier
+	{
+		Exact,
+		Fast,
+		Table,
+		TierCount
+	};
+
+	struct Accuracy
+	{
+		double maxError;  // largest absolute difference to libm over sin and cos
+		double rmsError;
+		double nsScalar;  // time per angle of Get
+		double nsBatch;   // time per angle of Batch
+	};
+
+	static const char* GetName(Tier tier);
+
+	static void Get(Tier tier, double x, double& s, double& c);
+	static double Sin(Tier tier, double x);
+	static double Cos(Tier tier, double x);
+
+	// s[i] = sin(t * x[i]), c[i] = cos(t * x[i]), the product is formed in double precision
+	static void Batch(Tier tier, const float* x, float t, float* s, float* c, size_t count);
+
+	// compares the tier against libm over a sweep of angles up to 2pi * 1e5
+	static Accuracy Measure(Tier tier);
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include "sincos.h"
+
+// vector cores of the Fast and Table tiers, shared by the batch of SinCos and the wavelet kernels.
+// both take 8 angles as two double vectors (the range reduction needs the precision)
+// and return 8 float results
+
+#define SINCOS_TABLE_SIZE 256
+
+// sin over a period and a quarter plus one sample, so cos (a quarter ahead) and the right
+// neighbour of the interpolation never have to wrap around
+const float* GetSinTable();
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SINCOS_X86
+#include <immintrin.h>
+
+// msvc accepts any intrinsic, gcc and clang need the instruction set enabled per function
+#if !defined(_MSC_VER)
+#define SINCOS_TARGET(x) __attribute__((target(x)))
+#else
+#define SINCOS_TARGET(x)
+#endif
+
+// sin and cos of r in [-pi/4, pi/4], rotated by quadrant * pi/2
+// minimax polynomials of cephes (sinf, cosf)
+SINCOS_TARGET("avx2,fma")
+static inline void SinCosPolynomialAVX2(__m256 r, __m256i quadrant, __m256& s, __m256& c)
+{
+	const __m256 z = _mm256_mul_ps(r, r);
+
+	__m256 ps = _mm256_fmadd_ps(_mm256_set1_ps(-1.9515295891e-4f), z, _mm256_set1_ps(8.3321608736e-3f));
+	ps = _mm256_fmadd_ps(ps, z, _mm256_set1_ps(-1.6666654611e-1f));
+	ps = _mm256_fmadd_ps(_mm256_mul_ps(ps, z), r, r);
+
+	__m256 pc = _mm256_fmadd_ps(_mm256_set1_ps(2.443315711809948e-5f), z, _mm256_set1_ps(-1.388731625493765e-3f));
+	pc = _mm256_fmadd_ps(pc, z, _mm256_set1_ps(4.166664568298827e-2f));
+	pc = _mm256_fmadd_ps(_mm256_mul_ps(pc, z), z, _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, _mm256_set1_ps(1.0f)));
+
+	// odd quadrants swap sin and cos, sin is negative in quadrants 2 and 3, cos in 1 and 2
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i two = _mm256_set1_epi32(2);
+	const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one));
+	const __m256 signS = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, two), 30));
+	const __m256 signC = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, one), two), 30));
+
+	s = _mm256_xor_ps(_mm256_blendv_ps(ps, pc, swap), signS);
+	c = _mm256_xor_ps(_mm256_blendv_ps(pc, ps, swap), signC);
+}
+
+SINCOS_TARGET("avx2,fma")
+static inline void SinCosFastAVX2(__m256d x0, __m256d x1, __m256& s, __m256& c)
+{
+	const __m256d twoOverPi = _mm256_set1_pd(0.63661977236758134308);
+	const __m256d halfPiHi = _mm256_set1_pd(1.5707963267948966);
+	const __m256d halfPiLo = _mm256_set1_pd(6.123233995736766e-17);
+
+	// the quadrant and the remainder in double, the remainder is small enough for float
+	const __m256d q0 = _mm256_round_pd(_mm256_mul_pd(x0, twoOverPi), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	const __m256d q1 = _mm256_round_pd(_mm256_mul_pd(x1, twoOverPi), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	const __m256d r0 = _mm256_fnmadd_pd(q0, halfPiLo, _mm256_fnmadd_pd(q0, halfPiHi, x0));
+	const __m256d r1 = _mm256_fnmadd_pd(q1, halfPiLo, _mm256_fnmadd_pd(q1, halfPiHi, x1));
+
+	SinCosPolynomialAVX2(_mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(r0)), _mm256_cvtpd_ps(r1), 1),
+		_mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvtpd_epi32(q0)), _mm256_cvtpd_epi32(q1), 1), s, c);
+}
+
+SINCOS_TARGET("avx2,fma")
+static inline void SinCosTableAVX2(__m256d x0, __m256d x1, const float* table, __m256& s, __m256& c)
+{
+	const __m256d scale = _mm256_set1_pd(SINCOS_TABLE_SIZE / 6.283185307179586);
+
+	const __m256d u0 = _mm256_mul_pd(x0, scale);
+	const __m256d u1 = _mm256_mul_pd(x1, scale);
+	const __m256d i0 = _mm256_floor_pd(u0);
+	const __m256d i1 = _mm256_floor_pd(u1);
+
+	const __m256 f = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(_mm256_sub_pd(u0, i0))), _mm256_cvtpd_ps(_mm256_sub_pd(u1, i1)), 1);
+	const __m256i index = _mm256_and_si256(_mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvtpd_epi32(i0)), _mm256_cvtpd_epi32(i1), 1),
+		_mm256_set1_epi32(SINCOS_TABLE_SIZE - 1));
+
+	const __m256 s0 = _mm256_i32gather_ps(table, index, 4);
+	const __m256 s1 = _mm256_i32gather_ps(table + 1, index, 4);
+	const __m256 c0 = _mm256_i32gather_ps(table + SINCOS_TABLE_SIZE / 4, index, 4);
+	const __m256 c1 = _mm256_i32gather_ps(table + SINCOS_TABLE_SIZE / 4 + 1, index, 4);
+
+	s = _mm256_fmadd_ps(f, _mm256_sub_ps(s1, s0), s0);
+	c = _mm256_fmadd_ps(f, _mm256_sub_ps(c1, c0), c0);
+}
+
+#endif
@@ -0,0 +1,200 @@
+#include "wavelet_kernels.h"
+#include "fft_kernels.h"
+#include "parallel.h"
+#include "sincos_simd.h"
+
+// below this the chain is cheaper than waking the pool
+static const size_t WAVELET_PARALLEL_SIZE = 1 << 15;
+static const size_t WAVELET_PARALLEL_GRAIN = 1 << 13;
+
+static_assert(sizeof(ImVec2) == 2 * sizeof(float), "the kernels treat ImVec2 arrays as interleaved floats");
+
+static void RotationsScalar(ImVec2* rotations, const float* indices, const float* radii, const float* signs, float t, size_t count, SinCos::Tier tier)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		double s, c;
+		SinCos::Get(tier, static_cast<double>(t) * indices[i], s, c);
+		rotations[i] = ImVec2(radii[i] * static_cast<float>(c), radii[i] * static_cast<float>(s) * signs[i]);
+	}
+}
+
+static ImVec2 PrefixSumScalar(ImVec2* tips, const ImVec2* rotations, ImVec2 offset, size_t count)
+{
+	ImVec2 tip = offset;
+	for (size_t i = 0; i < count; i++)
+	{
+		tip = ImVec2(tip.x + rotations[i].x, tip.y + rotations[i].y);
+		tips[i] = tip;
+	}
+	return tip;
+}
+
+static void OffsetScalar(ImVec2* tips, ImVec2 offset, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		tips[i] = ImVec2(tips[i].x + offset.x, tips[i].y + offset.y);
+}
+
+#ifdef SINCOS_X86
+
+SINCOS_TARGET("avx2,fma")
+static void RotationsAVX2(ImVec2* rotations, const float* indices, const float* radii, const float* signs, float t, size_t count, SinCos::Tier tier)
+{
+	if (tier == SinCos::Exact)
+	{
+		RotationsScalar(rotations, indices, radii, signs, t, count, tier);
+		return;
+	}
+
+	const float* table = GetSinTable();
+	const __m256d time = _mm256_set1_pd(t);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		// the angle in double, so large indices keep their phase
+		const __m256 index = _mm256_loadu_ps(indices + i);
+		const __m256d x0 = _mm256_mul_pd(time, _mm256_cvtps_pd(_mm256_castps256_ps128(index)));
+		const __m256d x1 = _mm256_mul_pd(time, _mm256_cvtps_pd(_mm256_extractf128_ps(index, 1)));
+
+		__m256 s, c;
+		if (tier == SinCos::Table)
+			SinCosTableAVX2(x0, x1, table, s, c);
+		else
+			SinCosFastAVX2(x0, x1, s, c);
+
+		const __m256 radius = _mm256_loadu_ps(radii + i);
+		const __m256 x = _mm256_mul_ps(radius, c);
+		const __m256 y = _mm256_mul_ps(_mm256_mul_ps(radius, s), _mm256_loadu_ps(signs + i));
+
+		// (x0 y0 x1 y1 | x4 y4 x5 y5) and (x2 y2 x3 y3 | x6 y6 x7 y7) back into wavelet order
+		const __m256 lo = _mm256_unpacklo_ps(x, y);
+		const __m256 hi = _mm256_unpackhi_ps(x, y);
+		float* out = &rotations[i].x;
+		_mm256_storeu_ps(out, _mm256_permute2f128_ps(lo, hi, 0x20));
+		_mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+	}
+
+	RotationsScalar(rotations + i, indices + i, radii + i, signs + i, t, count - i, tier);
+}
+
+// four tips per iteration: an in register scan of (x, y) pairs plus the running sum
+SINCOS_TARGET("avx2,fma")
+static ImVec2 PrefixSumAVX2(ImVec2* tips, const ImVec2* rotations, ImVec2 offset, size_t count)
+{
+	__m256 carry = _mm256_setr_ps(offset.x, offset.y, offset.x, offset.y, offset.x, offset.y, offset.x, offset.y);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256 v = _mm256_loadu_ps(&rotations[i].x);
+		// (r0, r0 + r1 | r2, r2 + r3)
+		v = _mm256_add_ps(v, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(v), 8)));
+		// the sum of the lower half goes into both tips of the upper half
+		const __m256 low = _mm256_permute_ps(v, _MM_SHUFFLE(3, 2, 3, 2));
+		v = _mm256_add_ps(v, _mm256_permute2f128_ps(low, low, 0x08));
+		v = _mm256_add_ps(v, carry);
+		_mm256_storeu_ps(&tips[i].x, v);
+
+		const __m256 last = _mm256_permute2f128_ps(v, v, 0x11);
+		carry = _mm256_permute_ps(last, _MM_SHUFFLE(3, 2, 3, 2));
+	}
+
+	float tail[8];
+	_mm256_storeu_ps(tail, carry);
+	return PrefixSumScalar(tips + i, rotations + i, ImVec2(tail[0], tail[1]), count - i);
+}
+
+SINCOS_TARGET("avx2,fma")
+static void OffsetAVX2(ImVec2* tips, ImVec2 offset, size_t count)
+{
+	const __m256 add = _mm256_setr_ps(offset.x, offset.y, offset.x, offset.y, offset.x, offset.y, offset.x, offset.y);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		_mm256_storeu_ps(&tips[i].x, _mm256_add_ps(_mm256_loadu_ps(&tips[i].x), add));
+	OffsetScalar(tips + i, offset, count - i);
+}
+
+#endif
+
+static const WaveletKernels kernels[] =
+{
+	{ "Scalar", RotationsScalar, PrefixSumScalar, OffsetScalar },
+#ifdef SINCOS_X86
+	{ "AVX2/FMA", RotationsAVX2, PrefixSumAVX2, OffsetAVX2 },
+#endif
+};
+
+// follows the fft kernels, so a lower level selected there applies here as well
+const WaveletKernels& WaveletKernels::Get()
+{
+#ifdef SINCOS_X86
+	if (FFTKernels::Get().level == FFTKernels::AVX2)
+		return kernels[1];
+#endif
+	return kernels[0];
+}
+
+// rotate(begin, n) fills the rotations of a block before it is summed, it is empty if they are known already
+static void Chain(ImVec2* tips, const ImVec2* rotations, size_t count, const std::function<void(size_t, size_t)>& rotate)
+{
+	const WaveletKernels& k = WaveletKernels::Get();
+
+	if (count < WAVELET_PARALLEL_SIZE || Parallel::GetThreadCount() == 1)
+	{
+		if (rotate)
+			rotate(0, count);
+		k.PrefixSum(tips, rotations, ImVec2(0.0f, 0.0f), count);
+		return;
+	}
+
+	const size_t blocks = (count + WAVELET_PARALLEL_GRAIN - 1) / WAVELET_PARALLEL_GRAIN;
+	std::vector<ImVec2> sums(blocks);
+
+	Parallel::For(0, blocks, 1, [&](size_t first, size_t last)
+		{
+			for (size_t b = first; b < last; b++)
+			{
+				const size_t begin = b * WAVELET_PARALLEL_GRAIN;
+				const size_t n = count - begin < WAVELET_PARALLEL_GRAIN ? count - begin : WAVELET_PARALLEL_GRAIN;
+				if (rotate)
+					rotate(begin, n);
+				sums[b] = k.PrefixSum(tips + begin, rotations + begin, ImVec2(0.0f, 0.0f), n);
+			}
+		});
+
+	// exclusive scan of the block sums, the first block is already in place
+	ImVec2 carry = ImVec2(0.0f, 0.0f);
+	for (size_t b = 0; b < blocks; b++)
+	{
+		const ImVec2 sum = sums[b];
+		sums[b] = carry;
+		carry = ImVec2(carry.x + sum.x, carry.y + sum.y);
+	}
+
+	Parallel::For(1, blocks, 1, [&](size_t first, size_t last)
+		{
+			for (size_t b = first; b < last; b++)
+			{
+				const size_t begin = b * WAVELET_PARALLEL_GRAIN;
+				const size_t n = count - begin < WAVELET_PARALLEL_GRAIN ? count - begin : WAVELET_PARALLEL_GRAIN;
+				k.Offset(tips + begin, sums[b], n);
+			}
+		});
+}
+
+void WaveletKernels::Evaluate(ImVec2* rotations, ImVec2* tips, const float* indices, const float* radii, const float* signs, float t, size_t count, SinCos::Tier tier)
+{
+	const WaveletKernels& k = Get();
+	Chain(tips, rotations, count, [&](size_t begin, size_t n)
+		{
+			k.Rotations(rotations + begin, indices + begin, radii + begin, signs + begin, t, n, tier);
+		});
+}
+
+void WaveletKernels::Accumulate(ImVec2* tips, const ImVec2* rotations, size_t count)
+{
+	Chain(tips, rotations, count, nullptr);
+}
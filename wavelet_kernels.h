@@ -0,0 +1,32 @@
+#pragma once
+#include "fourier.h"
+#include "sincos.h"
+
+// batch evaluation of the wavelet chain of the fourier series concept.
+// the rotation of a wavelet depends only on its own index, radius and sign, the tip is the sum
+// of all rotations up to it, so the chain is one vectorized sincos pass (of the given tier) followed by a prefix sum.
+// the instruction set is the one detected for the fft kernels, AVX2 evaluates 8 wavelets at once,
+// everything else falls back to the scalar kernels
+struct WaveletKernels
+{
+	const char* name;
+
+	// rotations[i] = radii[i] * (cos(t * indices[i]), signs[i] * sin(t * indices[i]))
+	// the angle is formed in double precision, so large indices keep their phase
+	void (*Rotations)(ImVec2* rotations, const float* indices, const float* radii, const float* signs, float t, size_t count, SinCos::Tier tier);
+
+	// tips[i] = offset + rotations[0] + ... + rotations[i], returns the last tip (offset if count is 0)
+	ImVec2 (*PrefixSum)(ImVec2* tips, const ImVec2* rotations, ImVec2 offset, size_t count);
+
+	// tips[i] += offset
+	void (*Offset)(ImVec2* tips, ImVec2 offset, size_t count);
+
+	static const WaveletKernels& Get();
+
+	// rotations and tips of all wavelets, large chains are split into blocks over the thread pool:
+	// every block is rotated and summed on its own, then the block sums are carried forward
+	static void Evaluate(ImVec2* rotations, ImVec2* tips, const float* indices, const float* radii, const float* signs, float t, size_t count, SinCos::Tier tier);
+
+	// tips only, for rotations that are already known (eg. from the rotors)
+	static void Accumulate(ImVec2* tips, const ImVec2* rotations, size_t count);
+};